@@ -0,0 +1,33 @@
+#include <delaunay/batch.hpp>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+int main(int argc, char** argv) {
+  using namespace std;
+
+  const size_t set_count = (argc > 1) ? stoul(argv[1]) : 10000;
+  const size_t set_size = (argc > 2) ? stoul(argv[2]) : 100;
+  const size_t threads =
+      (argc > 3) ? stoul(argv[3]) : delaunay::default_thread_count();
+
+  mt19937 rng{random_device{}()};
+  uniform_real_distribution<float> dist{-1, 1};
+  vector<vector<delaunay::point>> sets(set_count);
+  for (auto& set : sets) {
+    set.resize(set_size);
+    for (auto& p : set) p = {dist(rng), dist(rng)};
+  }
+
+  const auto result = delaunay::triangulate_batch(sets, threads);
+
+  cout << "sets = " << result.size() << '\n'
+       << "points per set = " << set_size << '\n'
+       << "threads = " << threads << '\n'
+       << "triangles = " << result.indices.size() / 3 << '\n'
+       << "t = " << result.seconds << " s\n"
+       << "throughput = " << fixed << setprecision(1)
+       << result.sets_per_second() << " sets/s\n";
+}
@@ -0,0 +1,82 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <delaunay/delaunay.hpp>
+#include <delaunay/parallel.hpp>
+#include <memory>
+#include <ranges>
+#include <span>
+#include <vector>
+
+namespace delaunay {
+
+// Triangulations of many point sets in compressed sparse row layout.
+// The indices of set i are stored in [offsets[i], offsets[i + 1])
+// and refer to the points of that set.
+struct batch_result {
+  size_t size() const noexcept { return offsets.size() - 1; }
+
+  std::span<const uint32_t> operator[](size_t i) const noexcept {
+    return std::span{indices}.subspan(offsets[i], offsets[i + 1] - offsets[i]);
+  }
+
+  double sets_per_second() const noexcept {
+    return (seconds > 0.0) ? size() / seconds : 0.0;
+  }
+
+  std::vector<uint32_t> indices{};
+  std::vector<size_t> offsets{0};
+  double seconds{};
+};
+
+// Every set has to be a contiguous range of planar points.
+template <std::ranges::random_access_range Sets>
+requires std::ranges::contiguous_range<std::ranges::range_value_t<Sets>>
+batch_result triangulate_batch(const Sets& sets,
+                               size_t threads = default_thread_count()) {
+  using set_type = std::ranges::range_value_t<Sets>;
+  using point_type = std::ranges::range_value_t<set_type>;
+  using workspace = basic_triangulation<std::span<const point_type>>;
+
+  const auto start = std::chrono::steady_clock::now();
+  const size_t n = std::ranges::size(sets);
+  threads = std::max(size_t{1}, std::min(threads, n));
+
+  // Every thread reuses its own triangulation and index buffer.
+  // The indices of a set are appended to the buffer of its thread
+  // and their location is stored to be able to gather them afterwards.
+  struct location {
+    size_t thread, first, count;
+  };
+  const auto workspaces = std::make_unique<workspace[]>(threads);
+  std::vector<std::vector<uint32_t>> buffers(threads);
+  std::vector<location> locations(n);
+
+  parallel_for(n, threads, [&](size_t i, size_t thread) {
+    auto& triangulation = workspaces[thread];
+    auto& buffer = buffers[thread];
+    triangulation.reset(std::span<const point_type>{
+        std::ranges::data(sets[i]), std::ranges::size(sets[i])});
+    triangulation.build();
+    locations[i] = {thread, buffer.size(), triangulation.index_count()};
+    triangulation.export_indices(std::back_inserter(buffer));
+  });
+
+  const trace::scope scope{"gather"};
+  batch_result result{};
+  result.offsets.resize(n + 1);
+  for (size_t i = 0; i < n; ++i)
+    result.offsets[i + 1] = result.offsets[i] + locations[i].count;
+  result.indices.resize(result.offsets[n]);
+  parallel_for(n, threads, [&](size_t i, size_t) {
+    const auto& l = locations[i];
+    std::copy_n(buffers[l.thread].begin() + l.first, l.count,
+                result.indices.begin() + result.offsets[i]);
+  });
+
+  const auto end = std::chrono::steady_clock::now();
+  result.seconds = std::chrono::duration<double>(end - start).count();
+  return result;
+}
+
+}  // namespace delaunay
@@ -0,0 +1,117 @@
+#include <delaunay/benchmark.hpp>
+#include <delaunay/delaunay.hpp>
+#include <delaunay/verify.hpp>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+template <typename Instrumentation>
+std::string run(std::string_view distribution, size_t n, uint64_t seed,
+                bool latency, bool verify) {
+  using namespace std;
+  namespace bench = delaunay::benchmark;
+
+  const auto points = bench::generate(distribution, n, seed);
+  delaunay::counting_resource memory{};
+  delaunay::basic_triangulation<span<const delaunay::point>, Instrumentation>
+      triangulation{points, &memory};
+  delaunay::latency_recorder recorder{};
+  if (latency) triangulation.latency = &recorder;
+  const auto build = bench::seconds([&] { triangulation.build(); });
+  vector<uint32_t> indices(triangulation.index_count());
+  const auto export_time =
+      bench::seconds([&] { triangulation.export_indices(span{indices}); });
+  const auto triangles = triangulation.triangles.size();
+
+  ostringstream json{};
+  json << "{\"distribution\": \"" << distribution << "\", \"points\": " << n
+       << ", \"triangles\": " << triangles
+       << ", \"build_seconds\": " << build
+       << ", \"export_seconds\": " << export_time
+       << ", \"inserts_per_second\": " << n / build
+       << ", \"triangles_per_second\": " << triangles / build
+       << ", \"peak_rss_bytes\": " << bench::peak_rss()
+       << ", \"peak_pool_bytes\": " << memory.peak_bytes() << ", \"memory\": ";
+  write_json(json, triangulation.memory_usage());
+  if (latency) {
+    const auto s = recorder.snapshot();
+    json << ", \"insert_latency_ns\": {\"p50\": " << s.p50()
+         << ", \"p99\": " << s.p99() << ", \"p999\": " << s.p999()
+         << ", \"max\": " << s.max << "}";
+  }
+  if (verify) {
+    const auto v = delaunay::verify(points, indices);
+    json << ", \"valid\": " << (v.valid() ? "true" : "false")
+         << ", \"euler_characteristic\": " << v.euler_characteristic()
+         << ", \"non_delaunay_edges\": " << v.non_delaunay_edges;
+  }
+  if constexpr (Instrumentation::enabled) {
+    json << ", \"stats\": ";
+    write_json(json, triangulation.stats());
+  }
+  json << "}";
+  return json.str();
+}
+
+// Headless benchmark of the triangulation for standard point distributions.
+// Results are written as JSON to track performance regressions.
+int main(int argc, char** argv) {
+  using namespace std;
+  namespace bench = delaunay::benchmark;
+
+  // The builder scans all triangles for every insertion.
+  // Hence, large sizes have to be requested explicitly.
+  size_t max_size = 100'000;
+  uint64_t seed = 0;
+  string distribution{};
+  string output{};
+  bool stats = false;
+  bool latency = false;
+  bool verify = false;
+  for (int i = 1; i < argc; ++i) {
+    const string arg{argv[i]};
+    if ((arg == "--max-size") && (i + 1 < argc))
+      max_size = stoul(argv[++i]);
+    else if ((arg == "--seed") && (i + 1 < argc))
+      seed = stoull(argv[++i]);
+    else if ((arg == "--distribution") && (i + 1 < argc))
+      distribution = argv[++i];
+    else if ((arg == "--output") && (i + 1 < argc))
+      output = argv[++i];
+    else if (arg == "--stats")
+      stats = true;
+    else if (arg == "--latency")
+      latency = true;
+    else if (arg == "--verify")
+      verify = true;
+    else
+      throw invalid_argument{"Unknown argument '" + arg + "'!"};
+  }
+
+  vector<string> results{};
+  for (const auto name : bench::distributions) {
+    if (!distribution.empty() && (name != distribution)) continue;
+    for (size_t n = 1'000; n <= min(max_size, size_t{10'000'000}); n *= 10) {
+      results.push_back(bench::isolated([&] {
+        using namespace delaunay;
+        return stats ? run<counting_instrumentation>(name, n, seed, latency,
+                                                     verify)
+                     : run<no_instrumentation>(name, n, seed, latency, verify);
+      }));
+      cerr << results.back() << '\n';
+    }
+  }
+
+  ofstream file{};
+  if (!output.empty()) file.open(output);
+  ostream& out = output.empty() ? cout : file;
+  out << "{\"benchmark\": \"triangulation\", \"seed\": " << seed
+      << ", \"results\": [";
+  for (size_t i = 0; i < results.size(); ++i)
+    out << (i ? ",\n  " : "\n  ") << results[i];
+  out << "\n]}\n";
+}
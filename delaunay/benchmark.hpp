@@ -0,0 +1,147 @@
+#pragma once
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <delaunay/points.hpp>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace delaunay::benchmark {
+
+// Standard point distributions used to compare builders.
+// All of them lie roughly inside the square [-1, 1] x [-1, 1].
+inline constexpr std::string_view distributions[] = {
+    "uniform_square", "uniform_disk", "gaussian",        "clustered",
+    "grid",           "circle",       "nearly_collinear"};
+
+inline std::vector<point> generate(std::string_view distribution, size_t n,
+                                   uint64_t seed) {
+  using namespace std;
+  mt19937_64 rng{seed};
+  uniform_real_distribution<float> uniform{-1, 1};
+  normal_distribution<float> normal{0, 0.5f};
+  constexpr float pi = 3.14159265358979f;
+
+  vector<point> points(n);
+  if (distribution == "uniform_square") {
+    for (auto& p : points) p = {uniform(rng), uniform(rng)};
+  } else if (distribution == "uniform_disk") {
+    for (auto& p : points) {
+      const auto r = sqrt(0.5f * (uniform(rng) + 1));
+      const auto phi = pi * uniform(rng);
+      p = {r * cos(phi), r * sin(phi)};
+    }
+  } else if (distribution == "gaussian") {
+    for (auto& p : points) p = {normal(rng), normal(rng)};
+  } else if (distribution == "clustered") {
+    constexpr size_t clusters = 16;
+    point centers[clusters];
+    for (auto& c : centers) c = {uniform(rng), uniform(rng)};
+    normal_distribution<float> spread{0, 0.02f};
+    for (auto& p : points) {
+      const auto& c = centers[rng() % clusters];
+      p = {c.x + spread(rng), c.y + spread(rng)};
+    }
+  } else if (distribution == "grid") {
+    const auto m = max(size_t{1}, size_t(ceil(sqrt(double(n)))));
+    for (size_t i = 0; i < n; ++i)
+      points[i] = {2.0f * (i % m) / m - 1, 2.0f * (i / m) / m - 1};
+    shuffle(points.begin(), points.end(), rng);
+  } else if (distribution == "circle") {
+    for (auto& p : points) {
+      const auto phi = pi * uniform(rng);
+      p = {cos(phi), sin(phi)};
+    }
+  } else if (distribution == "nearly_collinear") {
+    for (auto& p : points) {
+      const auto t = uniform(rng);
+      p = {t, 0.5f * t + 1e-4f * uniform(rng)};
+    }
+  } else {
+    throw invalid_argument{"Unknown point distribution '" +
+                           string{distribution} + "'!"};
+  }
+  return points;
+}
+
+// Peak resident set size of the calling process in bytes.
+inline size_t peak_rss() noexcept {
+  rusage usage{};
+  getrusage(RUSAGE_SELF, &usage);
+  return size_t(usage.ru_maxrss) * 1024;
+}
+
+template <typename F>
+double seconds(F&& f) {
+  const auto start = std::chrono::steady_clock::now();
+  f();
+  const auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double>(end - start).count();
+}
+
+// Quoted JSON string with escaped quotes, backslashes and control
+// characters, such that arbitrary paths can be written into reports.
+inline std::string json_string(std::string_view s) {
+  constexpr char hex[] = "0123456789abcdef";
+  std::string result{"\""};
+  for (const char c : s) {
+    if ((c == '"') || (c == '\\')) {
+      result += '\\';
+      result += c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      result += "\\u00";
+      result += hex[c >> 4];
+      result += hex[c & 15];
+    } else {
+      result += c;
+    }
+  }
+  result += '"';
+  return result;
+}
+
+// Runs f in a forked child process and returns the string it produces.
+// Every case gets its own address space and hence its own peak RSS.
+template <typename F>
+std::string isolated(F&& f) {
+  int fd[2];
+  if (pipe(fd) != 0) throw std::runtime_error{"Could not create pipe!"};
+  const auto pid = fork();
+  if (pid < 0) throw std::runtime_error{"Could not fork benchmark process!"};
+  if (pid == 0) {
+    close(fd[0]);
+    std::string s{};
+    try {
+      s = f();
+    } catch (...) {
+      _exit(1);
+    }
+    for (size_t i = 0; i < s.size();) {
+      const auto written = write(fd[1], s.data() + i, s.size() - i);
+      if (written <= 0) _exit(1);
+      i += written;
+    }
+    _exit(0);
+  }
+  close(fd[1]);
+  std::string result{};
+  char buffer[4096];
+  for (ssize_t n; (n = read(fd[0], buffer, sizeof(buffer))) > 0;)
+    result.append(buffer, n);
+  close(fd[0]);
+  int status;
+  waitpid(pid, &status, 0);
+  if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+    throw std::runtime_error{"Benchmark process failed!"};
+  return result;
+}
+
+}  // namespace delaunay::benchmark
@@ -1,150 +1,411 @@
 #pragma once
+#include <cmath>
+#include <cstdint>
 #include <delaunay/geometry.hpp>
-#include <unordered_map>
+#include <delaunay/instrumentation.hpp>
+#include <delaunay/latency.hpp>
+#include <delaunay/memory.hpp>
+#include <delaunay/parallel.hpp>
+#include <delaunay/points.hpp>
+#include <delaunay/recording.hpp>
+#include <delaunay/trace.hpp>
+#include <memory_resource>
+#include <numeric>
+#include <optional>
+#include <span>
+#include <stdexcept>
 #include <unordered_set>
 #include <vector>
 
 namespace delaunay {
 
-struct point {
-  float x, y;
-};
-
 struct circle {
   point center;
   float radius;
 };
 
-struct triangulation {
-  struct edge {
-    struct hash {
-      constexpr size_t operator()(const edge& e) const noexcept {
-        return e.pid[0] ^ (e.pid[1] << 1);
-      }
-    };
+struct edge {
+  struct hash {
+    constexpr size_t operator()(const edge& e) const noexcept {
+      return e.pid[0] ^ (e.pid[1] << 1);
+    }
+  };
 
-    edge(size_t pid1, size_t pid2)
-        : pid{std::min(pid1, pid2), std::max(pid1, pid2)} {}
+  // Edges are directed to be able to recover the orientation
+  // of the triangles that enclose a cavity.
+  edge(size_t pid1, size_t pid2) : pid{pid1, pid2} {}
 
-    size_t pid[2];
+  size_t pid[2];
+};
+
+struct triangle {
+  struct hash {
+    constexpr size_t operator()(const triangle& t) const noexcept {
+      return t.pid[0] ^ (t.pid[1] << 1) ^ (t.pid[2] << 2);
+    }
   };
 
-  struct triangle {
-    struct hash {
-      constexpr size_t operator()(const triangle& t) const noexcept {
-        return t.pid[0] ^ (t.pid[1] << 1) ^ (t.pid[2] << 2);
-      }
-    };
-
-    triangle(size_t pid0, size_t pid1, size_t pid2) : pid{pid0, pid1, pid2} {
-      if (pid[0] > pid[1]) std::swap(pid[0], pid[1]);
-      if (pid[1] > pid[2]) std::swap(pid[1], pid[2]);
-      if (pid[0] > pid[1]) std::swap(pid[0], pid[1]);
-
-      // Make sure clockwise and counterclockwise orders are preserved.
-      // Move minimal index to start and cyclically interchange others.
-      // if (pid[0] < pid[1]) {
-      //   if (pid[2] < pid[0]) {
-      //     pid[0] = pid2;
-      //     pid[1] = pid0;
-      //     pid[2] = pid1;
-      //   }
-      // } else {
-      //   if (pid[1] < pid[2]) {
-      //     pid[0] = pid1;
-      //     pid[1] = pid2;
-      //     pid[2] = pid0;
-      //   } else {
-      //     pid[0] = pid2;
-      //     pid[1] = pid0;
-      //     pid[2] = pid1;
-      //   }
-      // }
+  triangle(size_t pid0, size_t pid1, size_t pid2) : pid{pid0, pid1, pid2} {
+    // Make sure clockwise and counterclockwise orders are preserved.
+    // Move minimal index to start and cyclically interchange others.
+    if ((pid1 < pid0) && (pid1 < pid2)) {
+      pid[0] = pid1;
+      pid[1] = pid2;
+      pid[2] = pid0;
+    } else if ((pid2 < pid0) && (pid2 < pid1)) {
+      pid[0] = pid2;
+      pid[1] = pid0;
+      pid[2] = pid1;
     }
+  }
+
+  size_t pid[3];
+};
+
+constexpr bool operator==(const edge& e1, const edge& e2) noexcept {
+  return (e1.pid[0] == e2.pid[0]) && (e1.pid[1] == e2.pid[1]);
+}
+
+constexpr bool operator==(const triangle& t1, const triangle& t2) noexcept {
+  return (t1.pid[0] == t2.pid[0]) && (t1.pid[1] == t2.pid[1]) &&
+         (t1.pid[2] == t2.pid[2]);
+}
+
+// Basic Delaunay triangulation that only stores point indices.
+// The points are read from the given point source, which either owns
+// its points or is a borrowed view of memory owned by the caller.
+// The instrumentation policy decides which counters are recorded.
+template <point_source Points = std::vector<point>,
+          typename Instrumentation = no_instrumentation>
+struct basic_triangulation {
+  // Symbolic index of the vertex at infinity.
+  // Every convex hull edge (a, b) is shared with a ghost triangle (a, b, ∞).
+  static constexpr size_t ghost = ~size_t{0};
 
-    size_t pid[3];
+  using edge = delaunay::edge;
+  using triangle = delaunay::triangle;
+  using triangle_set = std::pmr::unordered_set<triangle, triangle::hash>;
+  using edge_set = std::pmr::unordered_set<edge, edge::hash>;
+
+  basic_triangulation() = default;
+  explicit basic_triangulation(Points p) : points{std::move(p)} {}
+  // All nodes and buckets are allocated from the given upstream resource,
+  // which may be a counting_resource to track or limit the footprint.
+  explicit basic_triangulation(std::pmr::memory_resource* upstream)
+      : pool{upstream} {}
+  basic_triangulation(Points p, std::pmr::memory_resource* upstream)
+      : points{std::move(p)}, pool{upstream} {}
+  // The node pool is owned by the triangulation and cannot be shared.
+  basic_triangulation(const basic_triangulation&) = delete;
+  basic_triangulation& operator=(const basic_triangulation&) = delete;
+
+  // Removes all points and triangles but keeps allocated memory,
+  // such that the object can be reused without allocator traffic.
+  void clear();
+  // Clears the triangulation and borrows another point source.
+  void reset(Points p);
+  // Presizes all containers for the given number of points.
+  void reserve(size_t n);
+
+  void add(const point& p) requires owning_point_source<Points>;
+  // Points have to be inserted in the order of their indices.
+  void insert(size_t pid);
+  // Inserts all points of the point source.
+  void build();
+
+  // Read-only range over all finite triangles.
+  struct triangle_view {
+    auto begin() const noexcept { return triangles->begin(); }
+    auto end() const noexcept { return triangles->end(); }
+    auto size() const noexcept { return triangles->size(); }
+    bool empty() const noexcept { return triangles->empty(); }
+
+    const triangle_set* triangles;
   };
 
-  void add(const point& p);
-
-  std::vector<uint32_t> triangle_data(std::vector<point>& data) {
-    for (const auto& p : data) add(p);
-    std::vector<uint32_t> result{};
-    for (auto it = triangles.begin(); it != triangles.end(); ++it) {
-      auto& t = *it;
-      const auto mask = (~size_t{0}) << 2;
-      if ((t.pid[0] & mask) && (t.pid[1] & mask) && (t.pid[2] & mask)) {
-        result.push_back(t.pid[0] - 4);
-        result.push_back(t.pid[1] - 4);
-        result.push_back(t.pid[2] - 4);
-      }
+  triangle_view view() const noexcept { return {&triangles}; }
+
+  const triangulation_stats& stats() const noexcept
+      requires Instrumentation::enabled {
+    return instrumentation.stats;
+  }
+
+  memory_report memory_usage() const noexcept;
+
+  // Exact number of indices written by the export functions.
+  size_t index_count() const noexcept { return 3 * triangles.size(); }
+
+  template <typename OutputIt>
+  OutputIt export_indices(OutputIt out) const {
+    for (const auto& t : triangles) {
+      *out++ = t.pid[0];
+      *out++ = t.pid[1];
+      *out++ = t.pid[2];
     }
+    return out;
+  }
+
+  // The given buffer has to provide space for index_count() indices.
+  void export_indices(std::span<uint32_t> out) const;
+  void export_indices(std::span<uint32_t> out, size_t threads) const;
+
+  std::vector<uint32_t> triangle_data() const {
+    std::vector<uint32_t> result(index_count());
+    export_indices(std::span{result});
     return result;
   }
 
-  template <typename Vector>
-  std::vector<uint32_t> triangle_data(const std::vector<Vector>& data) {
+  template <planar_point Vector>
+  std::vector<uint32_t> triangle_data(const std::vector<Vector>& data) requires
+      owning_point_source<Points> {
     for (const auto& p : data) add({p.x, p.y});
-    std::vector<uint32_t> result{};
-    for (auto it = triangles.begin(); it != triangles.end(); ++it) {
-      auto& t = *it;
-      const auto mask = (~size_t{0}) << 2;
-      if ((t.pid[0] & mask) && (t.pid[1] & mask) && (t.pid[2] & mask)) {
-        result.push_back(t.pid[0] - 4);
-        result.push_back(t.pid[1] - 4);
-        result.push_back(t.pid[2] - 4);
-      }
-    }
-    return result;
+    return triangle_data();
   }
 
-  std::vector<point> points{
-      {-300.0f, -300.0f},
-      {300.0f, -300.0f},
-      {300.0f, 300.0f},
-      {-300.0f, 300.0f},
-  };
-  std::unordered_set<triangle, triangle::hash> triangles{{0, 1, 2}, {2, 3, 0}};
-  std::unordered_map<edge, int, edge::hash> polygon{};
+  Points points{};
+  // Erased triangles and edges return their nodes to this pool
+  // from where they are reused by later insertions.
+  std::pmr::unsynchronized_pool_resource pool{};
+  // Finite triangles in counterclockwise order.
+  triangle_set triangles{&pool};
+  // Directed edges (a, b) of the ghost triangles (a, b, ∞).
+  // Hence, the convex hull is traversed in clockwise order.
+  edge_set hull{&pool};
+  // Directed boundary edges of the cavity of the last insertion.
+  edge_set polygon{&pool};
+  [[no_unique_address]] Instrumentation instrumentation{};
+  // Optional recorder for the latencies of add, clear, reset
+  // and every single insertion of build.
+  latency_recorder* latency{};
+  // Optional recorder of the mutation stream for offline replay.
+  // Points inserted by build are recorded as additions.
+  mutation_recorder* recording{};
 };
 
-constexpr bool operator==(const triangulation::edge& e1,
-                          const triangulation::edge& e2) noexcept {
-  return (e1.pid[0] == e2.pid[0]) && (e1.pid[1] == e2.pid[1]);
+using triangulation = basic_triangulation<>;
+
+template <point_source Points, typename Instrumentation>
+void basic_triangulation<Points, Instrumentation>::add(const point& p) requires
+    owning_point_source<Points> {
+  const latency_recorder::scope timer{latency};
+  if (recording) recording->add(p);
+  points.push_back(p);
+  insert(points.size() - 1);
 }
 
-constexpr bool operator==(const triangulation::triangle& t1,
-                          const triangulation::triangle& t2) noexcept {
-  return (t1.pid[0] == t2.pid[0]) && (t1.pid[1] == t2.pid[1]) &&
-         (t1.pid[2] == t2.pid[2]);
+template <point_source Points, typename Instrumentation>
+void basic_triangulation<Points, Instrumentation>::clear() {
+  const latency_recorder::scope timer{latency};
+  if (recording) recording->clear();
+  if constexpr (owning_point_source<Points>) points.clear();
+  triangles.clear();
+  hull.clear();
+  polygon.clear();
 }
 
-void triangulation::add(const point& p) {
-  size_t pid = points.size();
-  points.push_back(p);
+template <point_source Points, typename Instrumentation>
+void basic_triangulation<Points, Instrumentation>::reset(Points p) {
+  clear();
+  points = std::move(p);
+}
+
+template <point_source Points, typename Instrumentation>
+void basic_triangulation<Points, Instrumentation>::reserve(size_t n) {
+  if constexpr (owning_point_source<Points>) points.reserve(n);
+  // Euler's formula bounds the number of triangles by 2n.
+  triangles.reserve(2 * n);
+  // Hulls and cavities of typical inputs are much smaller than n.
+  // O(sqrt(n)) buckets avoid rehashing for all but degenerate inputs.
+  const auto boundary = size_t(std::sqrt(double(n))) + 16;
+  hull.reserve(boundary);
+  polygon.reserve(boundary);
+}
+
+template <point_source Points, typename Instrumentation>
+void basic_triangulation<Points, Instrumentation>::build() {
+  const trace::scope scope{"build"};
+  if (recording)
+    for (size_t i = 0; i < points.size(); ++i)
+      recording->add({points[i].x, points[i].y});
+  for (size_t i = 0; i < points.size(); ++i) {
+    const latency_recorder::scope timer{latency};
+    insert(i);
+  }
+}
+
+template <point_source Points, typename Instrumentation>
+void basic_triangulation<Points, Instrumentation>::insert(size_t pid) {
+  const geometry::point p{points[pid].x, points[pid].y};
 
+  // Until the first triangle exists, all points are assumed to be collinear.
+  // Wait for a point that spans a triangle with the first two distinct ones
+  // and insert the remaining points afterwards.
+  if (hull.empty()) {
+    size_t second = 1;
+    while ((second < pid) && (points[second].x == points[0].x) &&
+           (points[second].y == points[0].y))
+      ++second;
+    if (second >= pid) return;
+    const auto o = geometry::orientation({points[0].x, points[0].y},
+                                         {points[second].x, points[second].y},
+                                         p);
+    if (o == 0.0) return;
+    const size_t a = 0;
+    const size_t b = (o > 0.0) ? second : pid;
+    const size_t c = (o > 0.0) ? pid : second;
+    triangles.insert({a, b, c});
+    hull.insert({b, a});
+    hull.insert({c, b});
+    hull.insert({a, c});
+    for (size_t i = 1; i < pid; ++i)
+      if (i != second) insert(i);
+    return;
+  }
+
+  // Point location and cavity search are one scan over all triangles.
+  std::optional<trace::scope> phase{std::in_place, "cavity search"};
   polygon.clear();
+  const auto add_edge = [this](size_t pid1, size_t pid2) {
+    if constexpr (Instrumentation::enabled)
+      instrumentation.stats.polygon_probes.add(
+          polygon.bucket_size(polygon.bucket({pid2, pid1})));
+    const auto it = polygon.find({pid2, pid1});
+    if (it != polygon.end())
+      polygon.erase(it);
+    else
+      polygon.insert({pid1, pid2});
+  };
+
+  const size_t location_steps = triangles.size() + hull.size();
+  size_t incircle_tests = 0;
+  size_t cavity_triangles = 0;
 
   for (auto it = triangles.begin(); it != triangles.end();) {
     auto& t = *it;
-    if (geometry::circumcircle_intersection(
-            {{{points[t.pid[0]].x, points[t.pid[0]].y},
-              {points[t.pid[1]].x, points[t.pid[1]].y},
-              {points[t.pid[2]].x, points[t.pid[2]].y}}},
-            {p.x, p.y})) {
-      ++polygon[{t.pid[0], t.pid[1]}];
-      ++polygon[{t.pid[1], t.pid[2]}];
-      ++polygon[{t.pid[2], t.pid[0]}];
+    ++incircle_tests;
+    // Triangles are counterclockwise, so no orientation test is needed.
+    if (geometry::incircle({points[t.pid[0]].x, points[t.pid[0]].y},
+                           {points[t.pid[1]].x, points[t.pid[1]].y},
+                           {points[t.pid[2]].x, points[t.pid[2]].y},
+                           p) > 0.0) {
+      add_edge(t.pid[0], t.pid[1]);
+      add_edge(t.pid[1], t.pid[2]);
+      add_edge(t.pid[2], t.pid[0]);
+      ++cavity_triangles;
       it = triangles.erase(it);
     } else {
       ++it;
     }
   }
 
-  for (auto& [e, i] : polygon) {
-    if (i != 1) continue;
-    triangles.insert({e.pid[0], e.pid[1], pid});
+  for (auto it = hull.begin(); it != hull.end();) {
+    auto& e = *it;
+    ++incircle_tests;
+    if (geometry::halfplane_intersection(
+            {points[e.pid[0]].x, points[e.pid[0]].y},
+            {points[e.pid[1]].x, points[e.pid[1]].y}, p)) {
+      add_edge(e.pid[0], e.pid[1]);
+      add_edge(e.pid[1], ghost);
+      add_edge(ghost, e.pid[0]);
+      ++cavity_triangles;
+      it = hull.erase(it);
+    } else {
+      ++it;
+    }
   }
+
+  phase.emplace("retriangulation");
+  for (const auto& e : polygon) {
+    if (e.pid[0] == ghost) {
+      hull.insert({e.pid[1], pid});
+    } else if (e.pid[1] == ghost) {
+      hull.insert({pid, e.pid[0]});
+    } else {
+      const triangle t{e.pid[0], e.pid[1], pid};
+      if constexpr (Instrumentation::enabled)
+        instrumentation.stats.triangle_probes.add(
+            triangles.bucket_size(triangles.bucket(t)));
+      triangles.insert(t);
+    }
+  }
+
+  if constexpr (Instrumentation::enabled) {
+    auto& s = instrumentation.stats;
+    s.incircle_tests.add(incircle_tests);
+    s.cavity_triangles.add(cavity_triangles);
+    s.boundary_edges.add(polygon.size());
+    s.location_steps.add(location_steps);
+  }
+}
+
+template <point_source Points, typename Instrumentation>
+memory_report basic_triangulation<Points, Instrumentation>::memory_usage()
+    const noexcept {
+  // Every node stores its value and the pointer to the next node.
+  const auto node_size = [](const auto& set) {
+    return sizeof(void*) + sizeof(*set.begin());
+  };
+  const auto bucket_bytes = [](const auto& set) {
+    return set.bucket_count() * sizeof(void*);
+  };
+
+  memory_report result{};
+  if constexpr (requires { points.capacity(); })
+    result.points = points.capacity() * sizeof(points[0]);
+  result.triangles = triangles.size() * node_size(triangles);
+  result.hull = hull.size() * node_size(hull);
+  result.scratch = polygon.size() * node_size(polygon) + bucket_bytes(polygon);
+  result.buckets = bucket_bytes(triangles) + bucket_bytes(hull);
+  result.indices = index_count() * sizeof(uint32_t);
+  if (const auto counter =
+          dynamic_cast<const counting_resource*>(pool.upstream_resource()))
+    result.pool = counter->bytes();
+  return result;
+}
+
+template <point_source Points, typename Instrumentation>
+void basic_triangulation<Points, Instrumentation>::export_indices(
+    std::span<uint32_t> out) const {
+  const trace::scope scope{"export"};
+  if (out.size() < index_count())
+    throw std::length_error{"Index buffer is too small for triangulation!"};
+  export_indices(out.begin());
+}
+
+template <point_source Points, typename Instrumentation>
+void basic_triangulation<Points, Instrumentation>::export_indices(
+    std::span<uint32_t> out, size_t threads) const {
+  const trace::scope scope{"parallel export"};
+  if (out.size() < index_count())
+    throw std::length_error{"Index buffer is too small for triangulation!"};
+
+  // Chunks are ranges of hash buckets. Count their triangles first
+  // to know where every chunk has to start writing its indices.
+  threads = std::max(size_t{1}, threads);
+  const auto buckets = triangles.bucket_count();
+  const auto chunks = std::min(buckets, 8 * threads);
+  const auto first_bucket = [&](size_t chunk) {
+    return chunk * buckets / chunks;
+  };
+  std::vector<size_t> offsets(chunks + 1);
+  parallel_for(chunks, threads, [&](size_t chunk, size_t) {
+    size_t count = 0;
+    for (auto b = first_bucket(chunk); b < first_bucket(chunk + 1); ++b)
+      count += triangles.bucket_size(b);
+    offsets[chunk + 1] = 3 * count;
+  });
+  std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+  parallel_for(chunks, threads, [&](size_t chunk, size_t) {
+    auto it = out.begin() + offsets[chunk];
+    for (auto b = first_bucket(chunk); b < first_bucket(chunk + 1); ++b) {
+      for (auto t = triangles.begin(b); t != triangles.end(b); ++t) {
+        *it++ = t->pid[0];
+        *it++ = t->pid[1];
+        *it++ = t->pid[2];
+      }
+    }
+  });
 }
 
 }  // namespace delaunay
\ No newline at end of file
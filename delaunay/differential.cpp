@@ -0,0 +1,144 @@
+#include <delaunay/batch.hpp>
+#include <delaunay/benchmark.hpp>
+#include <delaunay/delaunay.hpp>
+#include <delaunay/fixed_triangulation.hpp>
+#include <delaunay/oracle.hpp>
+#include <delaunay/verify.hpp>
+#include <iomanip>
+#include <iostream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using delaunay::point;
+
+// Construction paths that have to produce identical meshes.
+// The first one is the reference for correctness and speed.
+struct engine {
+  const char* name;
+  // Required number of points or zero for engines that take any size.
+  size_t size;
+  std::vector<uint32_t> (*build)(std::span<const point>);
+};
+
+constexpr size_t fixed_size = 32;
+
+const engine engines[] = {
+    {"add", 0,
+     [](std::span<const point> points) {
+       delaunay::triangulation triangulation{};
+       for (const auto& p : points) triangulation.add(p);
+       return triangulation.triangle_data();
+     }},
+    {"build", 0,
+     [](std::span<const point> points) {
+       delaunay::basic_triangulation triangulation{points};
+       triangulation.build();
+       return triangulation.triangle_data();
+     }},
+    {"parallel_export", 0,
+     [](std::span<const point> points) {
+       delaunay::basic_triangulation triangulation{points};
+       triangulation.build();
+       std::vector<uint32_t> indices(triangulation.index_count());
+       triangulation.export_indices(std::span{indices},
+                                    delaunay::default_thread_count());
+       return indices;
+     }},
+    {"batch", 0,
+     [](std::span<const point> points) {
+       const std::span<const point> sets[] = {points};
+       return delaunay::triangulate_batch(sets).indices;
+     }},
+    {"fixed", fixed_size,
+     [](std::span<const point> points) {
+       std::array<point, fixed_size> input{};
+       std::copy_n(points.begin(), fixed_size, input.begin());
+       const auto triangulation = delaunay::triangulate(input);
+       std::vector<uint32_t> indices{};
+       for (const auto& t : triangulation)
+         indices.insert(indices.end(), t.begin(), t.end());
+       return indices;
+     }},
+};
+
+// Builds every input with all construction paths, compares the canonical
+// triangle sets with each other and, for small inputs, with a brute-force
+// oracle. The relative speed of all paths is reported in the same run.
+int main(int argc, char** argv) {
+  using namespace std;
+  namespace bench = delaunay::benchmark;
+
+  size_t n = 1'000;
+  size_t oracle_max = 64;
+  size_t repetitions = 5;
+  uint64_t seed = 0;
+  for (int i = 1; i < argc; ++i) {
+    const string arg{argv[i]};
+    if ((arg == "--size") && (i + 1 < argc))
+      n = stoul(argv[++i]);
+    else if ((arg == "--oracle-max") && (i + 1 < argc))
+      oracle_max = stoul(argv[++i]);
+    else if ((arg == "--repetitions") && (i + 1 < argc))
+      repetitions = max(size_t{1}, size_t(stoul(argv[++i])));
+    else if ((arg == "--seed") && (i + 1 < argc))
+      seed = stoull(argv[++i]);
+    else
+      throw invalid_argument{"Unknown argument '" + arg + "'!"};
+  }
+
+  cout << left << setw(18) << "distribution" << right << setw(8) << "points"
+       << "  " << left << setw(16) << "engine" << right << setw(12)
+       << "time [s]" << setw(10) << "speedup" << setw(11) << "reference"
+       << setw(8) << "oracle" << '\n';
+
+  bool failed = false;
+  for (const auto distribution : bench::distributions) {
+    for (const auto size : {fixed_size, n}) {
+      const auto points = bench::generate(distribution, size, seed);
+      delaunay::canonical_triangles oracle{};
+      if (size <= oracle_max)
+        oracle = delaunay::brute_force_triangulation(points);
+
+      delaunay::canonical_triangles reference{};
+      double reference_time = 0;
+      for (const auto& e : engines) {
+        if (e.size && (e.size != size)) continue;
+
+        vector<uint32_t> indices{};
+        double time = 0;
+        for (size_t r = 0; r < repetitions; ++r) {
+          const auto t = bench::seconds([&] { indices = e.build(points); });
+          time = r ? min(time, t) : t;
+        }
+        const auto triangles = delaunay::canonicalize(indices);
+        if (&e == &engines[0]) {
+          reference = triangles;
+          reference_time = time;
+        }
+
+        // Every Delaunay triangle is part of the oracle. The verifier
+        // makes sure that the triangles cover the whole convex hull.
+        const bool same = (triangles == reference);
+        string oracle_state = "-";
+        if (size <= oracle_max) {
+          const bool ok = includes(oracle.begin(), oracle.end(),
+                                   triangles.begin(), triangles.end()) &&
+                          delaunay::verify(points, indices).valid();
+          oracle_state = ok ? "ok" : "FAIL";
+          failed |= !ok;
+        }
+        failed |= !same;
+
+        cout << left << setw(18) << distribution << right << setw(8) << size
+             << "  " << left << setw(16) << e.name << right << setw(12)
+             << scientific << setprecision(3) << time << setw(10) << fixed
+             << setprecision(2) << reference_time / time << setw(11)
+             << (same ? "same" : "DIFFERENT") << setw(8) << oracle_state
+             << '\n';
+      }
+    }
+  }
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,184 @@
+#pragma once
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+
+// Exact geometric predicates based on floating-point expansions
+// as described by Shewchuk in "Adaptive Precision Floating-Point
+// Arithmetic and Fast Robust Geometric Predicates". An expansion is
+// a sum of non-overlapping doubles ordered by increasing magnitude.
+// Its sign is the sign of the last component. All routines are
+// constexpr and do not allocate, such that compile-time builders
+// can use them as well.
+namespace geometry::exact {
+
+// std::fabs is not constexpr, but the branch-free instruction
+// it maps to is essential for the speed of the filters.
+constexpr double abs(double x) noexcept {
+  if (std::is_constant_evaluated()) return (x < 0.0) ? -x : x;
+  return std::fabs(x);
+}
+
+constexpr void fast_two_sum(double a, double b, double& x, double& y) noexcept {
+  x = a + b;
+  y = b - (x - a);
+}
+
+constexpr void two_sum(double a, double b, double& x, double& y) noexcept {
+  x = a + b;
+  const double bv = x - a;
+  const double av = x - bv;
+  y = (a - av) + (b - bv);
+}
+
+constexpr void two_diff(double a, double b, double& x, double& y) noexcept {
+  x = a - b;
+  const double bv = a - x;
+  const double av = x + bv;
+  y = (a - av) + (bv - b);
+}
+
+// Dekker's split is used instead of fma to stay usable in constant
+// expressions.
+constexpr void split(double a, double& hi, double& lo) noexcept {
+  const double c = 134217729.0 * a;
+  hi = c - (c - a);
+  lo = a - hi;
+}
+
+constexpr void two_product(double a, double b, double& x, double& y) noexcept {
+  x = a * b;
+  double ahi, alo, bhi, blo;
+  split(a, ahi, alo);
+  split(b, bhi, blo);
+  y = alo * blo - (((x - ahi * bhi) - alo * bhi) - ahi * blo);
+}
+
+// Components are left uninitialized,
+// because large expansions are created for every exact evaluation.
+template <size_t N>
+struct expansion {
+  constexpr double sign() const noexcept { return terms[size - 1]; }
+
+  std::array<double, N> terms;
+  size_t size{};
+};
+
+constexpr auto difference(double a, double b) noexcept {
+  expansion<2> result;
+  double x, y;
+  two_diff(a, b, x, y);
+  if (y != 0.0) result.terms[result.size++] = y;
+  result.terms[result.size++] = x;
+  return result;
+}
+
+template <size_t N>
+constexpr auto operator-(expansion<N> e) noexcept {
+  for (size_t i = 0; i < e.size; ++i) e.terms[i] = -e.terms[i];
+  return e;
+}
+
+// Sum with zero elimination. Merges the components by magnitude.
+template <size_t N, size_t M>
+constexpr auto operator+(const expansion<N>& e,
+                         const expansion<M>& f) noexcept {
+  expansion<N + M> h;
+  size_t i = 0, j = 0;
+  const auto next = [&] {
+    const bool take_e =
+        (j == f.size) ||
+        ((i < e.size) && ((f.terms[j] > e.terms[i]) ==
+                          (f.terms[j] > -e.terms[i])));
+    return take_e ? e.terms[i++] : f.terms[j++];
+  };
+  double q = next();
+  double hh = 0;
+  if ((i < e.size) || (j < f.size)) {
+    fast_two_sum(next(), q, q, hh);
+    if (hh != 0.0) h.terms[h.size++] = hh;
+  }
+  while ((i < e.size) || (j < f.size)) {
+    two_sum(q, next(), q, hh);
+    if (hh != 0.0) h.terms[h.size++] = hh;
+  }
+  if ((q != 0.0) || (h.size == 0)) h.terms[h.size++] = q;
+  return h;
+}
+
+template <size_t N, size_t M>
+constexpr auto operator-(const expansion<N>& e,
+                         const expansion<M>& f) noexcept {
+  return e + -f;
+}
+
+// Product of an expansion and a double with zero elimination.
+template <size_t N>
+constexpr auto scale(const expansion<N>& e, double b) noexcept {
+  expansion<2 * N> h;
+  double q, hh;
+  two_product(e.terms[0], b, q, hh);
+  if (hh != 0.0) h.terms[h.size++] = hh;
+  for (size_t i = 1; i < e.size; ++i) {
+    double p1, p0, s;
+    two_product(e.terms[i], b, p1, p0);
+    two_sum(q, p0, s, hh);
+    if (hh != 0.0) h.terms[h.size++] = hh;
+    fast_two_sum(p1, s, q, hh);
+    if (hh != 0.0) h.terms[h.size++] = hh;
+  }
+  if ((q != 0.0) || (h.size == 0)) h.terms[h.size++] = q;
+  return h;
+}
+
+template <size_t N, size_t M>
+constexpr auto operator*(const expansion<N>& e,
+                         const expansion<M>& f) noexcept {
+  expansion<2 * N * M> h;
+  h.terms[0] = 0.0;
+  h.size = 1;
+  for (size_t j = 0; j < f.size; ++j) {
+    const auto p = scale(e, f.terms[j]);
+    const auto s = h + p;
+    h.size = s.size;
+    for (size_t i = 0; i < s.size; ++i) h.terms[i] = s.terms[i];
+  }
+  return h;
+}
+
+// The exact predicates need large stack frames. They are kept out of line,
+// so that filtered predicates do not pay for them when the filter succeeds.
+
+// Sign of (b - a) x (c - a). Positive for counterclockwise order.
+[[gnu::noinline]] constexpr double orientation(double ax, double ay,
+                                               double bx, double by,
+                                               double cx,
+                                               double cy) noexcept {
+  const auto abx = difference(bx, ax);
+  const auto aby = difference(by, ay);
+  const auto acx = difference(cx, ax);
+  const auto acy = difference(cy, ay);
+  return (abx * acy - aby * acx).sign();
+}
+
+// Positive if d lies inside the circumcircle of the counterclockwise
+// triangle (a, b, c), negative if outside and zero if on the circle.
+[[gnu::noinline]] constexpr double incircle(double ax, double ay, double bx,
+                                            double by, double cx, double cy,
+                                            double dx, double dy) noexcept {
+  const auto adx = difference(ax, dx);
+  const auto ady = difference(ay, dy);
+  const auto bdx = difference(bx, dx);
+  const auto bdy = difference(by, dy);
+  const auto cdx = difference(cx, dx);
+  const auto cdy = difference(cy, dy);
+  const auto alift = adx * adx + ady * ady;
+  const auto blift = bdx * bdx + bdy * bdy;
+  const auto clift = cdx * cdx + cdy * cdy;
+  return (alift * (bdx * cdy - cdx * bdy) + blift * (cdx * ady - adx * cdy) +
+          clift * (adx * bdy - bdx * ady))
+      .sign();
+}
+
+}  // namespace geometry::exact
@@ -0,0 +1,143 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <delaunay/geometry.hpp>
+#include <delaunay/points.hpp>
+
+namespace delaunay {
+
+// Delaunay triangulation of a fixed number of points
+// that is stored without any heap allocation.
+template <size_t N>
+struct fixed_triangulation {
+  // n points with h >= 3 points on the convex hull form 2n - 2 - h triangles.
+  static constexpr size_t capacity = (N < 3) ? 0 : 2 * N - 5;
+
+  constexpr size_t size() const noexcept { return count; }
+  constexpr auto begin() const noexcept { return triangles.begin(); }
+  constexpr auto end() const noexcept { return triangles.begin() + count; }
+
+  // Counterclockwise triangles with the minimal index at the start.
+  std::array<std::array<uint32_t, 3>, capacity> triangles{};
+  size_t count{};
+};
+
+namespace detail {
+
+// Bowyer-Watson insertion with ghost triangles as in basic_triangulation.
+// All containers are arrays with compile-time sizes. Only their used
+// prefixes are scanned linearly, which is the fastest choice for tiny
+// inputs. If the first points are collinear, the insertion of the first
+// triangle recursively inserts the skipped points.
+template <size_t N>
+struct fixed_builder {
+  static constexpr uint32_t ghost = ~uint32_t{0};
+
+  using edge = std::array<uint32_t, 2>;
+
+  constexpr geometry::point at(uint32_t pid) const noexcept {
+    return {points[pid].x, points[pid].y};
+  }
+
+  constexpr void add_triangle(uint32_t a, uint32_t b, uint32_t c) noexcept {
+    // Move minimal index to start and cyclically interchange others.
+    if ((b < a) && (b < c))
+      result.triangles[result.count++] = {b, c, a};
+    else if ((c < a) && (c < b))
+      result.triangles[result.count++] = {c, a, b};
+    else
+      result.triangles[result.count++] = {a, b, c};
+  }
+
+  constexpr void add_edge(uint32_t a, uint32_t b) noexcept {
+    for (size_t i = 0; i < polygon_size; ++i) {
+      if ((polygon[i][0] == b) && (polygon[i][1] == a)) {
+        polygon[i] = polygon[--polygon_size];
+        return;
+      }
+    }
+    polygon[polygon_size++] = {a, b};
+  }
+
+  constexpr void insert(uint32_t pid) noexcept {
+    const auto p = at(pid);
+
+    if (hull_size == 0) {
+      uint32_t second = 1;
+      while ((second < pid) && (points[second].x == points[0].x) &&
+             (points[second].y == points[0].y))
+        ++second;
+      if (second >= pid) return;
+      const auto o = geometry::orientation(at(0), at(second), p);
+      if (o == 0.0) return;
+      const uint32_t a = 0;
+      const uint32_t b = (o > 0.0) ? second : pid;
+      const uint32_t c = (o > 0.0) ? pid : second;
+      add_triangle(a, b, c);
+      hull[hull_size++] = {b, a};
+      hull[hull_size++] = {c, b};
+      hull[hull_size++] = {a, c};
+      for (uint32_t i = 1; i < pid; ++i)
+        if (i != second) insert(i);
+      return;
+    }
+
+    polygon_size = 0;
+    for (size_t i = 0; i < result.count;) {
+      const auto t = result.triangles[i];
+      if (geometry::incircle(at(t[0]), at(t[1]), at(t[2]), p) > 0.0) {
+        add_edge(t[0], t[1]);
+        add_edge(t[1], t[2]);
+        add_edge(t[2], t[0]);
+        result.triangles[i] = result.triangles[--result.count];
+      } else {
+        ++i;
+      }
+    }
+    for (size_t i = 0; i < hull_size;) {
+      const auto e = hull[i];
+      if (geometry::halfplane_intersection(at(e[0]), at(e[1]), p)) {
+        add_edge(e[0], e[1]);
+        add_edge(e[1], ghost);
+        add_edge(ghost, e[0]);
+        hull[i] = hull[--hull_size];
+      } else {
+        ++i;
+      }
+    }
+
+    for (size_t i = 0; i < polygon_size; ++i) {
+      const auto e = polygon[i];
+      if (e[0] == ghost)
+        hull[hull_size++] = {e[1], pid};
+      else if (e[1] == ghost)
+        hull[hull_size++] = {pid, e[0]};
+      else
+        add_triangle(e[0], e[1], pid);
+    }
+  }
+
+  const std::array<point, N>& points;
+  fixed_triangulation<N> result{};
+  std::array<edge, N> hull{};
+  size_t hull_size{};
+  // Shared cavity edges cancel out only after both triangles have been
+  // visited. Hence, reserve space for all edges of all triangles.
+  std::array<edge, 3 * (fixed_triangulation<N>::capacity + N)> polygon{};
+  size_t polygon_size{};
+};
+
+}  // namespace detail
+
+// Triangulates tiny inputs, like local re-meshing stencils, at compile time
+// or at run time without heap allocations. Only the loop over the points
+// has a compile-time bound. The loops over triangles, cavity and hull run
+// over their current sizes and are not unrolled.
+template <size_t N>
+constexpr auto triangulate(const std::array<point, N>& points) noexcept {
+  detail::fixed_builder<N> builder{points};
+  for (uint32_t i = 0; i < N; ++i) builder.insert(i);
+  return builder.result;
+}
+
+}  // namespace delaunay
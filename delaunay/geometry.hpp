@@ -1,5 +1,6 @@
 #pragma once
 #include <cmath>
+#include <delaunay/exact.hpp>
 
 namespace geometry {
 
@@ -53,29 +54,75 @@ constexpr auto intersection(const triangle& t, const point& p) noexcept {
   return ((u >= 0.0f) && (v >= 0.0f) && (u + v <= 1.0f));
 };
 
+// Twice the signed area of the triangle (a, b, c).
+// Positive for counterclockwise and negative for clockwise order.
+// The double precision result is only used if its error bound proves
+// the sign. Otherwise, the sign is computed exactly.
+constexpr auto orientation(const point& a, const point& b,
+                           const point& c) noexcept {
+  constexpr double epsilon = 0x1p-53;
+  constexpr double error_bound = (3.0 + 16.0 * epsilon) * epsilon;
+  const auto left = (double(b.x) - a.x) * (double(c.y) - a.y);
+  const auto right = (double(b.y) - a.y) * (double(c.x) - a.x);
+  const auto det = left - right;
+  if (exact::abs(det) > error_bound * (exact::abs(left) + exact::abs(right)))
+    return det;
+  return exact::orientation(a.x, a.y, b.x, b.y, c.x, c.y);
+}
+
+// Positive if d lies inside the circumcircle of the counterclockwise
+// triangle (a, b, c). Filtered like orientation.
+constexpr auto incircle(const point& a, const point& b, const point& c,
+                        const point& d) noexcept {
+  constexpr double epsilon = 0x1p-53;
+  constexpr double error_bound = (10.0 + 96.0 * epsilon) * epsilon;
+  const auto adx = double(a.x) - d.x;
+  const auto ady = double(a.y) - d.y;
+  const auto bdx = double(b.x) - d.x;
+  const auto bdy = double(b.y) - d.y;
+  const auto cdx = double(c.x) - d.x;
+  const auto cdy = double(c.y) - d.y;
+  const auto bdxcdy = bdx * cdy;
+  const auto cdxbdy = cdx * bdy;
+  const auto cdxady = cdx * ady;
+  const auto adxcdy = adx * cdy;
+  const auto adxbdy = adx * bdy;
+  const auto bdxady = bdx * ady;
+  const auto alift = adx * adx + ady * ady;
+  const auto blift = bdx * bdx + bdy * bdy;
+  const auto clift = cdx * cdx + cdy * cdy;
+  const auto det = alift * (bdxcdy - cdxbdy) + blift * (cdxady - adxcdy) +
+                   clift * (adxbdy - bdxady);
+  const auto permanent =
+      (exact::abs(bdxcdy) + exact::abs(cdxbdy)) * alift +
+      (exact::abs(cdxady) + exact::abs(adxcdy)) * blift +
+      (exact::abs(adxbdy) + exact::abs(bdxady)) * clift;
+  if (exact::abs(det) > error_bound * permanent) return det;
+  return exact::incircle(a.x, a.y, b.x, b.y, c.x, c.y, d.x, d.y);
+}
+
+// Robust test for the interior of the circumcircle of both orientations.
 constexpr auto circumcircle_intersection(const triangle& t,
                                          const point& p) noexcept {
-  const auto axdx = t.vertex[0].x - p.x;
-  const auto aydy = t.vertex[0].y - p.y;
-  const auto bxdx = t.vertex[1].x - p.x;
-  const auto bydy = t.vertex[1].y - p.y;
-  const auto cxdx = t.vertex[2].x - p.x;
-  const auto cydy = t.vertex[2].y - p.y;
-  const auto sqsum_a = axdx * axdx + aydy * aydy;
-  const auto sqsum_b = bxdx * bxdx + bydy * bydy;
-  const auto sqsum_c = cxdx * cxdx + cydy * cydy;
-  const auto det = axdx * (bydy * sqsum_c - cydy * sqsum_b) -
-                   aydy * (bxdx * sqsum_c - cxdx * sqsum_b) +
-                   sqsum_a * (bxdx * cydy - cxdx * bydy);
-  // return det > 0.0f;
-  const point edge1{t.vertex[1].x - t.vertex[0].x,
-                    t.vertex[1].y - t.vertex[0].y};
-  const point edge2{t.vertex[2].x - t.vertex[0].x,
-                    t.vertex[2].y - t.vertex[0].y};
-  const auto d = (edge1.x * edge2.y - edge1.y * edge2.x);
-  return (d * det) > 0.0f;
+  const auto o = orientation(t.vertex[0], t.vertex[1], t.vertex[2]);
+  const auto d = incircle(t.vertex[0], t.vertex[1], t.vertex[2], p);
+  return ((o > 0.0) && (d > 0.0)) || ((o < 0.0) && (d < 0.0));
 };
 
+// Check if p lies in the circumcircle of the degenerated triangle (a, b, ∞).
+// This is the open half-plane left of the directed line from a to b
+// together with the open segment between a and b.
+constexpr auto halfplane_intersection(const point& a, const point& b,
+                                      const point& p) noexcept {
+  const auto o = orientation(a, b, p);
+  if (o != 0.0) return o > 0.0;
+  const auto t = (double(p.x) - a.x) * (double(b.x) - a.x) +
+                 (double(p.y) - a.y) * (double(b.y) - a.y);
+  const auto l = (double(b.x) - a.x) * (double(b.x) - a.x) +
+                 (double(b.y) - a.y) * (double(b.y) - a.y);
+  return (t > 0.0) && (t < l);
+}
+
 constexpr auto bounding_box(const circle& c) noexcept {
   return aabb{{c.center.x - c.radius, c.center.y - c.radius},
               {c.center.x + c.radius, c.center.y + c.radius}};
@@ -32,8 +32,9 @@ int main() {
   vector<glm::vec2> points(samples);
   for (auto& p : points) p = glm::vec2{dist(rng), dist(rng)};
 
-  delaunay::triangulation triangulation{};
-  const auto elements = triangulation.triangle_data(points);
+  delaunay::basic_triangulation triangulation{std::span{points}};
+  triangulation.build();
+  const auto elements = triangulation.triangle_data();
   // vector<uint32_t> elements{0, 1, 2, 0, 1, 3};
 
   // Run the program.
@@ -0,0 +1,103 @@
+#pragma once
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace delaunay {
+
+// Writers for 8-bit RGB buffers whose rows are stored from bottom to top,
+// which is the order of the flipped images and the rendered tessellations.
+
+// Binary PPM (P6) with rows from top to bottom.
+inline void write_ppm(const std::string& path, int width, int height,
+                      std::span<const uint8_t> rgb) {
+  std::ofstream file{path, std::ios::binary};
+  if (!file) throw std::runtime_error("Could not open '" + path + "'!");
+  file << "P6\n" << width << ' ' << height << "\n255\n";
+  const size_t row = size_t(width) * 3;
+  for (int y = height - 1; y >= 0; --y)
+    file.write(reinterpret_cast<const char*>(&rgb[y * row]), row);
+  if (!file) throw std::runtime_error("Could not write '" + path + "'!");
+}
+
+// Uncompressed 24-bit BMP. Its rows are stored from bottom to top
+// in BGR order and padded to multiples of four bytes.
+inline void write_bmp(const std::string& path, int width, int height,
+                      std::span<const uint8_t> rgb) {
+  std::ofstream file{path, std::ios::binary};
+  if (!file) throw std::runtime_error("Could not open '" + path + "'!");
+  const uint32_t stride = (uint32_t(width) * 3 + 3) & ~3u;
+  const uint32_t data_size = stride * height;
+  uint8_t header[54]{'B', 'M'};
+  const auto put = [&header](size_t offset, uint32_t value) {
+    for (size_t i = 0; i < 4; ++i) header[offset + i] = value >> (8 * i);
+  };
+  put(2, 54 + data_size);
+  put(10, 54);
+  put(14, 40);
+  put(18, width);
+  put(22, height);
+  header[26] = 1;
+  header[28] = 24;
+  put(34, data_size);
+  file.write(reinterpret_cast<const char*>(header), sizeof(header));
+
+  std::vector<char> line(stride);
+  for (int y = 0; y < height; ++y) {
+    const auto in = &rgb[size_t(y) * width * 3];
+    for (int x = 0; x < width; ++x) {
+      line[3 * x] = in[3 * x + 2];
+      line[3 * x + 1] = in[3 * x + 1];
+      line[3 * x + 2] = in[3 * x];
+    }
+    file.write(line.data(), stride);
+  }
+  if (!file) throw std::runtime_error("Could not write '" + path + "'!");
+}
+
+// Sequential reader of binary PPM images with 8-bit channels. Rows are
+// read from top to bottom in strips, such that images larger than the
+// available memory can be processed.
+struct ppm_reader {
+  explicit ppm_reader(const std::string& path)
+      : file{path, std::ios::binary} {
+    if (!file) throw std::runtime_error("Could not open '" + path + "'!");
+    const auto next = [this] {
+      std::string token{};
+      while (file >> token && token.starts_with('#'))
+        file.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+      return token;
+    };
+    const auto number = [&] {
+      const auto token = next();
+      if (token.empty() ||
+          (token.find_first_not_of("0123456789") != std::string::npos))
+        throw std::runtime_error("Invalid PPM header in '" + path + "'!");
+      return std::stoi(token);
+    };
+    if (next() != "P6")
+      throw std::runtime_error("'" + path + "' is no binary PPM image!");
+    width = number();
+    height = number();
+    if (number() != 255)
+      throw std::runtime_error("'" + path + "' has no 8-bit channels!");
+    // A single whitespace separates the header from the pixels.
+    file.get();
+  }
+
+  // Reads the next rows into a buffer of rows * width * channels bytes.
+  void read_rows(uint8_t* out, int rows) {
+    file.read(reinterpret_cast<char*>(out), size_t(rows) * width * channels);
+    if (!file) throw std::runtime_error("Unexpected end of PPM data!");
+  }
+
+  std::ifstream file;
+  int width{}, height{};
+  static constexpr int channels = 3;
+};
+
+}  // namespace delaunay
@@ -0,0 +1,107 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <iterator>
+#include <ostream>
+#include <utility>
+
+namespace delaunay {
+
+// Histogram with logarithmic buckets.
+// Bucket 0 counts zeros and bucket k counts values in [2^(k-1), 2^k).
+struct histogram {
+  void add(size_t value) noexcept {
+    ++buckets[std::bit_width(value)];
+    ++count;
+    sum += value;
+    max = std::max(max, value);
+  }
+
+  double mean() const noexcept { return count ? double(sum) / count : 0.0; }
+
+  std::array<size_t, 65> buckets{};
+  size_t count{};
+  size_t sum{};
+  size_t max{};
+};
+
+// Counters of the hot path of basic_triangulation::insert.
+struct triangulation_stats {
+  // Number of circumcircle tests per insertion.
+  histogram incircle_tests{};
+  // Number of triangles and ghost triangles removed per insertion.
+  histogram cavity_triangles{};
+  // Number of edges on the boundary of every cavity.
+  histogram boundary_edges{};
+  // Point location scans all triangles and hull edges.
+  // This is the number of visited elements per insertion.
+  histogram location_steps{};
+  // Nodes visited in the hash bucket per lookup or insertion.
+  histogram triangle_probes{};
+  histogram polygon_probes{};
+};
+
+// Default policy of basic_triangulation. Nothing is recorded
+// and all instrumentation code is removed at compile time.
+struct no_instrumentation {
+  static constexpr bool enabled = false;
+};
+
+struct counting_instrumentation {
+  static constexpr bool enabled = true;
+  triangulation_stats stats{};
+};
+
+inline std::ostream& operator<<(std::ostream& os, const histogram& h) {
+  // The precision of the stream is restored for the following output.
+  const auto precision = os.precision(4);
+  os << "n = " << h.count << ", mean = " << h.mean();
+  os.precision(precision);
+  os << ", max = " << h.max << ", buckets = [";
+  const auto last = std::find_if(h.buckets.rbegin(), h.buckets.rend(),
+                                 [](auto b) { return b != 0; });
+  const size_t size = h.buckets.rend() - last;
+  for (size_t k = 0; k < size; ++k) os << (k ? " " : "") << h.buckets[k];
+  return os << "]";
+}
+
+inline std::ostream& operator<<(std::ostream& os,
+                                const triangulation_stats& s) {
+  return os << "incircle tests:   " << s.incircle_tests << '\n'
+            << "cavity triangles: " << s.cavity_triangles << '\n'
+            << "boundary edges:   " << s.boundary_edges << '\n'
+            << "location steps:   " << s.location_steps << '\n'
+            << "triangle probes:  " << s.triangle_probes << '\n'
+            << "polygon probes:   " << s.polygon_probes << '\n';
+}
+
+// Writes the statistics as a JSON object.
+inline void write_json(std::ostream& os, const histogram& h) {
+  os << "{\"count\": " << h.count << ", \"mean\": " << h.mean()
+     << ", \"max\": " << h.max << ", \"log2_buckets\": [";
+  const auto last = std::find_if(h.buckets.rbegin(), h.buckets.rend(),
+                                 [](auto b) { return b != 0; });
+  const size_t size = h.buckets.rend() - last;
+  for (size_t k = 0; k < size; ++k) os << (k ? ", " : "") << h.buckets[k];
+  os << "]}";
+}
+
+inline void write_json(std::ostream& os, const triangulation_stats& s) {
+  const std::pair<const char*, const histogram*> entries[] = {
+      {"incircle_tests", &s.incircle_tests},
+      {"cavity_triangles", &s.cavity_triangles},
+      {"boundary_edges", &s.boundary_edges},
+      {"location_steps", &s.location_steps},
+      {"triangle_probes", &s.triangle_probes},
+      {"polygon_probes", &s.polygon_probes}};
+  os << "{";
+  for (size_t i = 0; i < std::size(entries); ++i) {
+    os << (i ? ", " : "") << '"' << entries[i].first << "\": ";
+    write_json(os, *entries[i].second);
+  }
+  os << "}";
+}
+
+}  // namespace delaunay
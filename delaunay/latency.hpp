@@ -0,0 +1,115 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+
+namespace delaunay {
+
+// Latency histogram in nanoseconds with logarithmic buckets.
+// Every power of two is split into eight linear sub-buckets.
+// Hence, reported percentiles are at most 12.5% too large.
+struct latency_snapshot {
+  static constexpr size_t bucket_count = 8 * 62;
+
+  static constexpr size_t bucket(uint64_t ns) noexcept {
+    if (ns < 8) return ns;
+    const size_t e = std::bit_width(ns) - 1;
+    return 8 * (e - 2) + ((ns >> (e - 3)) & 7);
+  }
+
+  // Largest value that is counted in the given bucket.
+  static constexpr uint64_t upper_bound(size_t bucket) noexcept {
+    if (bucket < 8) return bucket;
+    const size_t e = bucket / 8 + 2;
+    return ((uint64_t{9 + bucket % 8}) << (e - 3)) - 1;
+  }
+
+  uint64_t percentile(double q) const noexcept {
+    if (count == 0) return 0;
+    const auto rank = std::max(uint64_t{1}, uint64_t(q * count + 0.5));
+    uint64_t sum = 0;
+    for (size_t i = 0; i < bucket_count; ++i) {
+      sum += counts[i];
+      if (sum >= rank) return std::min(upper_bound(i), max);
+    }
+    return max;
+  }
+
+  uint64_t p50() const noexcept { return percentile(0.5); }
+  uint64_t p99() const noexcept { return percentile(0.99); }
+  uint64_t p999() const noexcept { return percentile(0.999); }
+
+  std::array<uint64_t, bucket_count> counts{};
+  uint64_t count{};
+  uint64_t max{};
+};
+
+// Records latencies of mutating triangulation calls. Recording costs two
+// clock reads and two relaxed atomic updates, so it can stay enabled in
+// production. Snapshots may be taken from another thread.
+struct latency_recorder {
+  struct scope {
+    explicit scope(latency_recorder* r) noexcept
+        : recorder{r},
+          start{r ? std::chrono::steady_clock::now()
+                  : std::chrono::steady_clock::time_point{}} {}
+    scope(const scope&) = delete;
+    scope& operator=(const scope&) = delete;
+    ~scope() {
+      if (!recorder) return;
+      const auto end = std::chrono::steady_clock::now();
+      recorder->record(
+          std::chrono::duration_cast<std::chrono::nanoseconds>(end - start)
+              .count());
+    }
+
+    latency_recorder* recorder;
+    std::chrono::steady_clock::time_point start;
+  };
+
+  void record(uint64_t ns) noexcept {
+    counts[latency_snapshot::bucket(ns)].fetch_add(1,
+                                                   std::memory_order_relaxed);
+    auto m = max.load(std::memory_order_relaxed);
+    while ((m < ns) &&
+           !max.compare_exchange_weak(m, ns, std::memory_order_relaxed)) {
+    }
+  }
+
+  latency_snapshot snapshot() const noexcept {
+    latency_snapshot result{};
+    for (size_t i = 0; i < latency_snapshot::bucket_count; ++i) {
+      result.counts[i] = counts[i].load(std::memory_order_relaxed);
+      result.count += result.counts[i];
+    }
+    result.max = max.load(std::memory_order_relaxed);
+    return result;
+  }
+
+  // Returns all latencies recorded since the last reset
+  // and starts a new reporting period.
+  latency_snapshot snapshot_and_reset() noexcept {
+    latency_snapshot result{};
+    for (size_t i = 0; i < latency_snapshot::bucket_count; ++i) {
+      result.counts[i] = counts[i].exchange(0, std::memory_order_relaxed);
+      result.count += result.counts[i];
+    }
+    result.max = max.exchange(0, std::memory_order_relaxed);
+    return result;
+  }
+
+  std::array<std::atomic<uint64_t>, latency_snapshot::bucket_count> counts{};
+  std::atomic<uint64_t> max{};
+};
+
+inline std::ostream& operator<<(std::ostream& os, const latency_snapshot& s) {
+  return os << "n = " << s.count << ", p50 = " << s.p50()
+            << " ns, p99 = " << s.p99() << " ns, p999 = " << s.p999()
+            << " ns, max = " << s.max << " ns";
+}
+
+}  // namespace delaunay
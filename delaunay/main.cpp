@@ -1,8 +1,10 @@
 #include <SFML/Graphics.hpp>
 #include <chrono>
+#include <cstdlib>
 #include <delaunay/delaunay.hpp>
 #include <iomanip>
 #include <iostream>
+#include <optional>
 #include <random>
 #include <vector>
 
@@ -12,7 +14,16 @@ int main() {
   mt19937 rng{random_device{}()};
   uniform_real_distribution<float> dist{-1, 1};
 
-  delaunay::triangulation triangulation{};
+  delaunay::basic_triangulation<vector<delaunay::point>,
+                                delaunay::counting_instrumentation>
+      triangulation{};
+
+  // Set DELAUNAY_RECORD to capture the session for the replay tool.
+  optional<delaunay::mutation_recorder> recording{};
+  if (const auto path = getenv("DELAUNAY_RECORD")) {
+    recording.emplace(path);
+    triangulation.recording = &*recording;
+  }
 
   size_t width = 800;
   size_t height = 800;
@@ -90,6 +101,10 @@ int main() {
                    << triangulation.points.size() << " points" << setw(20)
                    << triangulation.triangles.size() << " triangles" << '\n';
               break;
+
+            case sf::Keyboard::S:
+              cout << triangulation.stats() << flush;
+              break;
           }
           break;
       }
@@ -0,0 +1,113 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <limits>
+#include <memory_resource>
+#include <new>
+#include <ostream>
+
+namespace delaunay {
+
+// Bytes of a triangulation by component.
+// Node sizes follow the layout of the standard library hash sets.
+struct memory_report {
+  size_t total() const noexcept {
+    return points + triangles + hull + scratch + buckets;
+  }
+
+  // Owned point storage. Borrowed point sources count as zero.
+  size_t points{};
+  // Nodes of the triangle and hull sets.
+  size_t triangles{};
+  size_t hull{};
+  // Nodes and buckets of the cavity boundary of the last insertion.
+  size_t scratch{};
+  // Bucket arrays of the triangle and hull sets.
+  size_t buckets{};
+  // Size of an index buffer for the export functions.
+  // It is not owned by the triangulation and not part of the total.
+  size_t indices{};
+  // Bytes the node pool holds from its upstream resource, including
+  // unused blocks. Only known if the upstream is a counting_resource.
+  size_t pool{};
+};
+
+// Memory resource that counts the bytes requested from its upstream.
+// It can be shared by triangulations that live in different threads.
+// Allocations beyond the limit throw std::bad_alloc to enforce budgets.
+// A triangulation that runs out of budget has to be cleared before reuse.
+struct counting_resource : std::pmr::memory_resource {
+  explicit counting_resource(
+      size_t budget = std::numeric_limits<size_t>::max(),
+      std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+      : limit{budget}, upstream{resource} {}
+
+  size_t bytes() const noexcept {
+    return allocated.load(std::memory_order_relaxed);
+  }
+  size_t peak_bytes() const noexcept {
+    return peak.load(std::memory_order_relaxed);
+  }
+  size_t allocation_count() const noexcept {
+    return allocations.load(std::memory_order_relaxed);
+  }
+
+  size_t limit;
+  std::pmr::memory_resource* upstream;
+
+ private:
+  void* do_allocate(size_t size, size_t alignment) override {
+    const auto old = allocated.fetch_add(size, std::memory_order_relaxed);
+    if (old + size > limit) {
+      allocated.fetch_sub(size, std::memory_order_relaxed);
+      throw std::bad_alloc{};
+    }
+    void* result;
+    try {
+      result = upstream->allocate(size, alignment);
+    } catch (...) {
+      allocated.fetch_sub(size, std::memory_order_relaxed);
+      throw;
+    }
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    auto p = peak.load(std::memory_order_relaxed);
+    while ((p < old + size) && !peak.compare_exchange_weak(
+                                   p, old + size, std::memory_order_relaxed)) {
+    }
+    return result;
+  }
+
+  void do_deallocate(void* ptr, size_t size, size_t alignment) override {
+    upstream->deallocate(ptr, size, alignment);
+    allocated.fetch_sub(size, std::memory_order_relaxed);
+  }
+
+  bool do_is_equal(
+      const std::pmr::memory_resource& other) const noexcept override {
+    return this == &other;
+  }
+
+  std::atomic<size_t> allocated{};
+  std::atomic<size_t> peak{};
+  std::atomic<size_t> allocations{};
+};
+
+inline std::ostream& operator<<(std::ostream& os, const memory_report& m) {
+  return os << "points:    " << m.points << " B\n"
+            << "triangles: " << m.triangles << " B\n"
+            << "hull:      " << m.hull << " B\n"
+            << "scratch:   " << m.scratch << " B\n"
+            << "buckets:   " << m.buckets << " B\n"
+            << "total:     " << m.total() << " B\n"
+            << "indices:   " << m.indices << " B\n"
+            << "pool:      " << m.pool << " B\n";
+}
+
+inline void write_json(std::ostream& os, const memory_report& m) {
+  os << "{\"points\": " << m.points << ", \"triangles\": " << m.triangles
+     << ", \"hull\": " << m.hull << ", \"scratch\": " << m.scratch
+     << ", \"buckets\": " << m.buckets << ", \"total\": " << m.total()
+     << ", \"indices\": " << m.indices << ", \"pool\": " << m.pool << "}";
+}
+
+}  // namespace delaunay
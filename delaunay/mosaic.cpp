@@ -45,8 +45,9 @@ int main() {
   points[3].x = -1;
   points[3].y = 1;
 
-  delaunay::triangulation triangulation{};
-  const auto elements = triangulation.triangle_data(points);
+  delaunay::basic_triangulation triangulation{std::span{points}};
+  triangulation.build();
+  const auto elements = triangulation.triangle_data();
   // vector<uint32_t> elements{0, 1, 2, 0, 1, 3};
 
   std::vector<vertex> vertices(elements.size());
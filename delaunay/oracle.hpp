@@ -0,0 +1,63 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <delaunay/geometry.hpp>
+#include <delaunay/points.hpp>
+#include <span>
+#include <vector>
+
+namespace delaunay {
+
+using canonical_triangles = std::vector<std::array<uint32_t, 3>>;
+
+// Brings the triangles of an index array into a unique form, such that the
+// outputs of different builders can be compared. Every triangle starts with
+// its minimal index without changing its orientation and the list is sorted.
+inline canonical_triangles canonicalize(std::span<const uint32_t> indices) {
+  canonical_triangles result(indices.size() / 3);
+  for (size_t i = 0; i < result.size(); ++i) {
+    auto& t = result[i];
+    t = {indices[3 * i], indices[3 * i + 1], indices[3 * i + 2]};
+    std::rotate(t.begin(), std::min_element(t.begin(), t.end()), t.end());
+  }
+  std::sort(result.begin(), result.end());
+  return result;
+}
+
+// All counterclockwise triangles whose circumcircle contains no other point.
+// For points in general position, this is the Delaunay triangulation.
+// Otherwise, every Delaunay triangulation is a subset. It takes O(n^4) time
+// with the same predicates as the builders and is meant for small n only.
+template <point_source Points>
+canonical_triangles brute_force_triangulation(const Points& points) {
+  const auto at = [&points](size_t i) {
+    return geometry::point{points[i].x, points[i].y};
+  };
+  const uint32_t n = points.size();
+  canonical_triangles result{};
+  for (uint32_t i = 0; i < n; ++i) {
+    for (uint32_t j = i + 1; j < n; ++j) {
+      for (uint32_t k = j + 1; k < n; ++k) {
+        const auto o = geometry::orientation(at(i), at(j), at(k));
+        if (o == 0.0) continue;
+        const geometry::triangle t =
+            (o > 0.0) ? geometry::triangle{{at(i), at(j), at(k)}}
+                      : geometry::triangle{{at(i), at(k), at(j)}};
+        bool empty = true;
+        for (uint32_t l = 0; (l < n) && empty; ++l)
+          empty = (l == i) || (l == j) || (l == k) ||
+                  !geometry::circumcircle_intersection(t, at(l));
+        if (!empty) continue;
+        if (o > 0.0)
+          result.push_back({i, j, k});
+        else
+          result.push_back({i, k, j});
+      }
+    }
+  }
+  std::sort(result.begin(), result.end());
+  return result;
+}
+
+}  // namespace delaunay
@@ -0,0 +1,37 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace delaunay {
+
+inline size_t default_thread_count() noexcept {
+  return std::max(1u, std::thread::hardware_concurrency());
+}
+
+// Calls f(i, thread) for every i in [0, n) by using the given number of
+// threads. Indices are handed out dynamically and the calling thread
+// takes part as thread 0. Hence, thread is valid index for per-thread data.
+template <typename F>
+void parallel_for(size_t n, size_t threads, F&& f) {
+  threads = std::min(threads, n);
+  if (threads <= 1) {
+    for (size_t i = 0; i < n; ++i) f(i, size_t{0});
+    return;
+  }
+
+  std::atomic<size_t> next{0};
+  const auto work = [&](size_t thread) {
+    for (size_t i; (i = next.fetch_add(1, std::memory_order_relaxed)) < n;)
+      f(i, thread);
+  };
+  std::vector<std::thread> workers{};
+  workers.reserve(threads - 1);
+  for (size_t t = 1; t < threads; ++t) workers.emplace_back(work, t);
+  work(0);
+  for (auto& worker : workers) worker.join();
+}
+
+}  // namespace delaunay
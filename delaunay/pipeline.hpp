@@ -0,0 +1,165 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace delaunay {
+
+// Blocking FIFO queue with a fixed capacity. Producers wait while it is
+// full, which propagates backpressure to the previous pipeline stage.
+template <typename T>
+struct bounded_queue {
+  explicit bounded_queue(size_t capacity) : capacity{capacity} {}
+
+  void push(T value) {
+    std::unique_lock lock{mutex};
+    not_full.wait(lock, [this] { return items.size() < capacity; });
+    items.push_back(std::move(value));
+    max_size = std::max(max_size, items.size());
+    not_empty.notify_one();
+  }
+
+  // Returns no value once the queue is closed and empty.
+  std::optional<T> pop() {
+    std::unique_lock lock{mutex};
+    not_empty.wait(lock, [this] { return !items.empty() || closed; });
+    if (items.empty()) return std::nullopt;
+    auto value = std::move(items.front());
+    items.pop_front();
+    not_full.notify_one();
+    return value;
+  }
+
+  // No more values will be pushed.
+  void close() {
+    const std::lock_guard lock{mutex};
+    closed = true;
+    not_empty.notify_all();
+  }
+
+  size_t capacity;
+  size_t max_size{};
+
+ private:
+  std::mutex mutex{};
+  std::condition_variable not_full{};
+  std::condition_variable not_empty{};
+  std::deque<T> items{};
+  bool closed{};
+};
+
+// Pipeline stage with its own pool of threads. Items for which
+// the function throws are counted as failures and dropped.
+template <typename T>
+struct pipeline_stage {
+  std::string name;
+  size_t threads;
+  std::function<void(T&)> process;
+};
+
+struct stage_stats {
+  double items_per_second() const noexcept {
+    return (seconds > 0.0) ? items / seconds : 0.0;
+  }
+  // Fraction of the available thread time spent in the stage function.
+  double utilization() const noexcept {
+    return (seconds > 0.0) ? busy_seconds / (seconds * threads) : 0.0;
+  }
+
+  std::string name{};
+  size_t threads{};
+  size_t items{};
+  size_t failures{};
+  // Time from the start of the pipeline until the last thread finished.
+  double seconds{};
+  // Summed time of all threads in the stage function.
+  double busy_seconds{};
+  // Largest number of items that waited in the input queue.
+  size_t max_queue{};
+  std::vector<std::string> errors{};
+};
+
+// Runs the stages one after another over all items. Neighboring stages are
+// connected by queues of the given capacity, such that at most a bounded
+// number of items is in flight. Items leave the pipeline after the last
+// stage. The statistics are returned in the order of the stages.
+template <typename T>
+std::vector<stage_stats> run_pipeline(
+    std::vector<T> items, const std::vector<pipeline_stage<T>>& stages,
+    size_t capacity = 4) {
+  using clock = std::chrono::steady_clock;
+  const auto start = clock::now();
+  const auto seconds = [](clock::duration d) {
+    return std::chrono::duration<double>(d).count();
+  };
+
+  std::vector<std::unique_ptr<bounded_queue<T>>> queues{};
+  for (size_t s = 0; s < stages.size(); ++s)
+    queues.push_back(std::make_unique<bounded_queue<T>>(capacity));
+  std::vector<stage_stats> stats(stages.size());
+  std::vector<std::mutex> mutexes(stages.size());
+
+  std::vector<std::vector<std::thread>> pools(stages.size());
+  for (size_t s = 0; s < stages.size(); ++s) {
+    stats[s].name = stages[s].name;
+    stats[s].threads = std::max(size_t{1}, stages[s].threads);
+    for (size_t t = 0; t < stats[s].threads; ++t) {
+      pools[s].emplace_back([&, s] {
+        auto& stat = stats[s];
+        while (auto item = queues[s]->pop()) {
+          const auto begin = clock::now();
+          std::optional<std::string> error{};
+          try {
+            stages[s].process(*item);
+          } catch (const std::exception& e) {
+            error = e.what();
+          }
+          const auto end = clock::now();
+          {
+            const std::lock_guard lock{mutexes[s]};
+            stat.busy_seconds += seconds(end - begin);
+            stat.seconds = std::max(stat.seconds, seconds(end - start));
+            if (error) {
+              ++stat.failures;
+              stat.errors.push_back(std::move(*error));
+            } else {
+              ++stat.items;
+            }
+          }
+          if (!error && (s + 1 < stages.size()))
+            queues[s + 1]->push(std::move(*item));
+        }
+      });
+    }
+  }
+
+  for (auto& item : items) queues[0]->push(std::move(item));
+  // A stage is done once its queue is closed and all its threads returned.
+  for (size_t s = 0; s < stages.size(); ++s) {
+    queues[s]->close();
+    for (auto& thread : pools[s]) thread.join();
+    stats[s].max_queue = queues[s]->max_size;
+  }
+  return stats;
+}
+
+inline std::ostream& operator<<(std::ostream& os, const stage_stats& s) {
+  return os << s.name << ": threads = " << s.threads << ", items = " << s.items
+            << ", failures = " << s.failures << ", t = " << s.seconds
+            << " s, throughput = " << s.items_per_second()
+            << " items/s, utilization = " << s.utilization()
+            << ", max queue = " << s.max_queue;
+}
+
+}  // namespace delaunay
@@ -0,0 +1,63 @@
+#pragma once
+#include <concepts>
+#include <cstddef>
+#include <cstring>
+
+namespace delaunay {
+
+struct point {
+  float x, y;
+};
+
+// Every type with public x and y coordinates, like glm::vec2 or sf::Vector2f.
+template <typename T>
+concept planar_point = requires(const T& p) {
+  { p.x } -> std::convertible_to<float>;
+  { p.y } -> std::convertible_to<float>;
+};
+
+// Random-access sequence of planar points the triangulation reads from.
+// Examples are std::vector<point>, std::span<const glm::vec2>,
+// transformed random-access views and strided_points.
+template <typename T>
+concept point_source = requires(const T& points, size_t i) {
+  { points[i] } -> planar_point;
+  { points.size() } -> std::convertible_to<size_t>;
+};
+
+// Point sources that new points can be appended to.
+template <typename T>
+concept owning_point_source =
+    point_source<T> && requires(T& points, const point& p) {
+  points.push_back(p);
+};
+
+// Non-owning view of coordinates inside an interleaved vertex buffer.
+// The i-th point is read from the bytes x + i * stride and y + i * stride.
+struct strided_points {
+  strided_points(const float* x, const float* y, size_t stride, size_t count)
+      : x{reinterpret_cast<const std::byte*>(x)},
+        y{reinterpret_cast<const std::byte*>(y)},
+        stride{stride},
+        count{count} {}
+
+  // Coordinates that directly follow each other, as in glm::vec3.
+  strided_points(const float* xy, size_t stride, size_t count)
+      : strided_points(xy, xy + 1, stride, count) {}
+
+  point operator[](size_t i) const noexcept {
+    point p;
+    std::memcpy(&p.x, x + i * stride, sizeof(float));
+    std::memcpy(&p.y, y + i * stride, sizeof(float));
+    return p;
+  }
+
+  size_t size() const noexcept { return count; }
+
+  const std::byte* x;
+  const std::byte* y;
+  size_t stride;
+  size_t count;
+};
+
+}  // namespace delaunay
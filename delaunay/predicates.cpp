@@ -0,0 +1,285 @@
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <delaunay/geometry.hpp>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+using geometry::point;
+
+// Counterclockwise triangle (a, b, c) and query point d for incircle.
+// Orientation is evaluated for (a, b, e).
+struct query {
+  point a, b, c, d, e;
+};
+
+// Keeps the compiler from removing the benchmarked computations.
+template <typename T>
+inline void keep(const T& value) {
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+inline uint64_t ticks() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  return 0;
+#endif
+}
+
+// Variants of the predicates that geometry.hpp does not provide.
+// The float versions are the kernels the triangulation started with.
+double incircle_float(const point& a, const point& b, const point& c,
+                      const point& d) {
+  const auto adx = a.x - d.x, ady = a.y - d.y;
+  const auto bdx = b.x - d.x, bdy = b.y - d.y;
+  const auto cdx = c.x - d.x, cdy = c.y - d.y;
+  const auto alift = adx * adx + ady * ady;
+  const auto blift = bdx * bdx + bdy * bdy;
+  const auto clift = cdx * cdx + cdy * cdy;
+  return alift * (bdx * cdy - cdx * bdy) + blift * (cdx * ady - adx * cdy) +
+         clift * (adx * bdy - bdx * ady);
+}
+
+double incircle_double(const point& a, const point& b, const point& c,
+                       const point& d) {
+  const auto adx = double(a.x) - d.x, ady = double(a.y) - d.y;
+  const auto bdx = double(b.x) - d.x, bdy = double(b.y) - d.y;
+  const auto cdx = double(c.x) - d.x, cdy = double(c.y) - d.y;
+  const auto alift = adx * adx + ady * ady;
+  const auto blift = bdx * bdx + bdy * bdy;
+  const auto clift = cdx * cdx + cdy * cdy;
+  return alift * (bdx * cdy - cdx * bdy) + blift * (cdx * ady - adx * cdy) +
+         clift * (adx * bdy - bdx * ady);
+}
+
+double incircle_exact(const point& a, const point& b, const point& c,
+                      const point& d) {
+  return geometry::exact::incircle(a.x, a.y, b.x, b.y, c.x, c.y, d.x, d.y);
+}
+
+double orientation_float(const point& a, const point& b, const point& c) {
+  return (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+}
+
+double orientation_double(const point& a, const point& b, const point& c) {
+  return (double(b.x) - a.x) * (double(c.y) - a.y) -
+         (double(b.y) - a.y) * (double(c.x) - a.x);
+}
+
+double orientation_exact(const point& a, const point& b, const point& c) {
+  return geometry::exact::orientation(a.x, a.y, b.x, b.y, c.x, c.y);
+}
+
+// Structure-of-arrays layout for the batch kernels. One query point is
+// tested against many triangles, like in the cavity search of the
+// triangulation. The loops have no branches and are vectorized.
+struct batch {
+  explicit batch(const std::vector<query>& queries) {
+    for (const auto& q : queries) {
+      ax.push_back(q.a.x);
+      ay.push_back(q.a.y);
+      bx.push_back(q.b.x);
+      by.push_back(q.b.y);
+      cx.push_back(q.c.x);
+      cy.push_back(q.c.y);
+      ex.push_back(q.e.x);
+      ey.push_back(q.e.y);
+    }
+    result.resize(queries.size());
+  }
+
+  void incircle(const point& d) noexcept {
+    const size_t n = result.size();
+    for (size_t i = 0; i < n; ++i) {
+      const double adx = ax[i] - d.x, ady = ay[i] - d.y;
+      const double bdx = bx[i] - d.x, bdy = by[i] - d.y;
+      const double cdx = cx[i] - d.x, cdy = cy[i] - d.y;
+      const double alift = adx * adx + ady * ady;
+      const double blift = bdx * bdx + bdy * bdy;
+      const double clift = cdx * cdx + cdy * cdy;
+      result[i] = alift * (bdx * cdy - cdx * bdy) +
+                  blift * (cdx * ady - adx * cdy) +
+                  clift * (adx * bdy - bdx * ady);
+    }
+  }
+
+  void orientation() noexcept {
+    const size_t n = result.size();
+    for (size_t i = 0; i < n; ++i)
+      result[i] = (double(bx[i]) - ax[i]) * (double(ey[i]) - ay[i]) -
+                  (double(by[i]) - ay[i]) * (double(ex[i]) - ax[i]);
+  }
+
+  std::vector<float> ax, ay, bx, by, cx, cy, ex, ey;
+  std::vector<double> result;
+};
+
+std::vector<query> generate(bool degenerate, size_t n, uint64_t seed) {
+  using namespace std;
+  mt19937_64 rng{seed};
+  uniform_real_distribution<float> uniform{-1, 1};
+  constexpr float pi = 3.14159265358979f;
+  vector<query> queries(n);
+  for (auto& q : queries) {
+    if (!degenerate) {
+      q = {{uniform(rng), uniform(rng)},
+           {uniform(rng), uniform(rng)},
+           {uniform(rng), uniform(rng)},
+           {uniform(rng), uniform(rng)},
+           {uniform(rng), uniform(rng)}};
+    } else {
+      // Points on the unit circle that are only rounded to float
+      // and a point on the line through a and b.
+      float phi[4];
+      for (auto& x : phi) x = pi * uniform(rng);
+      const auto on_circle = [](float x) { return point{cos(x), sin(x)}; };
+      q = {on_circle(phi[0]), on_circle(phi[1]), on_circle(phi[2]),
+           on_circle(phi[3]), {}};
+      const auto t = uniform(rng);
+      q.e = {q.a.x + t * (q.b.x - q.a.x), q.a.y + t * (q.b.y - q.a.y)};
+    }
+    if (geometry::orientation(q.a, q.b, q.c) < 0) std::swap(q.a, q.b);
+  }
+  return queries;
+}
+
+struct measurement {
+  double ns_per_op;
+  double ops_per_tick;
+};
+
+// Repeats f over all queries until enough time has passed.
+template <typename F>
+measurement measure(size_t n, F&& f) {
+  using namespace std::chrono;
+  size_t ops = 0;
+  const auto start = steady_clock::now();
+  const auto start_ticks = ticks();
+  auto end = start;
+  do {
+    f();
+    ops += n;
+    end = steady_clock::now();
+  } while (end - start < milliseconds{100});
+  const auto elapsed_ticks = ticks() - start_ticks;
+  return {duration<double, std::nano>(end - start).count() / ops,
+          elapsed_ticks ? double(ops) / elapsed_ticks : 0.0};
+}
+
+// Headless throughput benchmark of the predicates in geometry.hpp and their
+// float, double, filtered, exact and batch variants. Errors are the number
+// of signs that differ from the exact predicates on the same inputs.
+// Cycles are counted with the time stamp counter, which runs at a
+// constant rate that may differ from the current core clock.
+int main(int argc, char** argv) {
+  using namespace std;
+  const size_t n = (argc > 1) ? stoul(argv[1]) : 4096;
+  if (n == 0)
+    throw invalid_argument{"Usage: predicates [queries > 0] [seed]"};
+  const uint64_t seed = (argc > 2) ? stoull(argv[2]) : 0;
+
+  cout << left << setw(26) << "predicate" << setw(12) << "variant"
+       << setw(16) << "input" << right << setw(10) << "ns/op" << setw(12)
+       << "ops/cycle" << setw(8) << "errors" << '\n';
+  const auto report = [](const char* predicate, const char* variant,
+                         const char* input, measurement m, size_t errors) {
+    cout << left << setw(26) << predicate << setw(12) << variant << setw(16)
+         << input << right << fixed << setprecision(2) << setw(10)
+         << m.ns_per_op << setw(12) << setprecision(3) << m.ops_per_tick
+         << setw(8) << errors << '\n';
+  };
+  const auto sign = [](double x) { return (x > 0) - (x < 0); };
+
+  for (const bool degenerate : {false, true}) {
+    const auto input = degenerate ? "near_degenerate" : "random";
+    const auto queries = generate(degenerate, n, seed);
+
+    const auto incircle = [&](const char* variant, auto&& f) {
+      size_t errors = 0;
+      for (const auto& q : queries)
+        errors += sign(f(q.a, q.b, q.c, q.d)) !=
+                  sign(incircle_exact(q.a, q.b, q.c, q.d));
+      const auto m = measure(n, [&] {
+        for (const auto& q : queries) keep(f(q.a, q.b, q.c, q.d));
+      });
+      report("incircle", variant, input, m, errors);
+    };
+    incircle("float", incircle_float);
+    incircle("double", incircle_double);
+    incircle("filtered", [](auto&... p) { return geometry::incircle(p...); });
+    incircle("exact", incircle_exact);
+
+    const auto orientation = [&](const char* variant, auto&& f) {
+      size_t errors = 0;
+      for (const auto& q : queries)
+        errors += sign(f(q.a, q.b, q.e)) !=
+                  sign(orientation_exact(q.a, q.b, q.e));
+      const auto m = measure(n, [&] {
+        for (const auto& q : queries) keep(f(q.a, q.b, q.e));
+      });
+      report("orientation", variant, input, m, errors);
+    };
+    orientation("float", orientation_float);
+    orientation("double", orientation_double);
+    orientation("filtered",
+                [](auto&... p) { return geometry::orientation(p...); });
+    orientation("exact", orientation_exact);
+
+    batch b{queries};
+    size_t errors = 0;
+    b.incircle(queries[0].d);
+    for (size_t i = 0; i < n; ++i)
+      errors += sign(b.result[i]) !=
+                sign(incircle_exact(queries[i].a, queries[i].b, queries[i].c,
+                                    queries[0].d));
+    report("incircle", "batch", input, measure(n, [&] {
+             b.incircle(queries[0].d);
+             keep(b.result.data());
+           }),
+           errors);
+    errors = 0;
+    b.orientation();
+    for (size_t i = 0; i < n; ++i)
+      errors += sign(b.result[i]) !=
+                sign(orientation_exact(queries[i].a, queries[i].b,
+                                       queries[i].e));
+    report("orientation", "batch", input, measure(n, [&] {
+             b.orientation();
+             keep(b.result.data());
+           }),
+           errors);
+
+    // Remaining functions of geometry.hpp only exist in float.
+    const auto triangle = [](const query& q) {
+      return geometry::triangle{{q.a, q.b, q.c}};
+    };
+    report("circumcircle_intersection", "filtered", input, measure(n, [&] {
+             for (const auto& q : queries)
+               keep(geometry::circumcircle_intersection(triangle(q), q.d));
+           }),
+           0);
+    report("circumcircle", "float", input, measure(n, [&] {
+             for (const auto& q : queries)
+               keep(geometry::circumcircle(triangle(q)));
+           }),
+           0);
+    report("intersection", "float", input, measure(n, [&] {
+             for (const auto& q : queries)
+               keep(geometry::intersection(triangle(q), q.d));
+           }),
+           0);
+    report("bounding_box", "float", input, measure(n, [&] {
+             for (const auto& q : queries)
+               keep(geometry::bounding_box(triangle(q)));
+           }),
+           0);
+  }
+}
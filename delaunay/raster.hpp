@@ -0,0 +1,216 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <delaunay/parallel.hpp>
+#include <delaunay/points.hpp>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace delaunay {
+
+// Edge function (b - a) x (p - a) of a directed triangle edge.
+// It is evaluated with the endpoints in a canonical order and negated
+// for the reverse direction. Hence, the two triangles sharing an edge get
+// exactly opposite values and never both claim a pixel on that edge.
+struct raster_edge {
+  raster_edge(point a, point b) noexcept
+      : u{a}, v{b}, flip{(b.x < a.x) || ((b.x == a.x) && (b.y < a.y))} {
+    if (flip) std::swap(u, v);
+    // Top-left fill rule for counterclockwise triangles with y pointing up.
+    // Pixels on the edge belong to the triangle if the edge is a left edge
+    // or a horizontal top edge.
+    const auto dx = b.x - a.x;
+    const auto dy = b.y - a.y;
+    owner = (dy < 0) || ((dy == 0) && (dx < 0));
+  }
+
+  double operator()(double x, double y) const noexcept {
+    const auto e =
+        (double(v.x) - u.x) * (y - u.y) - (double(v.y) - u.y) * (x - u.x);
+    return flip ? -e : e;
+  }
+
+  bool covers(double x, double y) const noexcept {
+    const auto e = (*this)(x, y);
+    return (e > 0) || ((e == 0) && owner);
+  }
+
+  point u, v;
+  bool flip;
+  bool owner;
+};
+
+// Calls f(y, x0, x1) for every pixel row y and the span [x0, x1) of pixels
+// whose centers (x + 0.5, y + 0.5) lie inside the given triangle. Only
+// pixels of the clip rectangle [xmin, xmax) x [ymin, ymax) are visited.
+// Because of the fill rule, every pixel center is covered by at most one
+// triangle of a mesh. Spans are found from the row intersections and
+// refined with the edge functions, so only the covered pixels and two per
+// row are visited.
+template <typename F>
+void rasterize(point a, point b, point c, int xmin, int ymin, int xmax,
+               int ymax, F&& f) {
+  const auto o = (double(b.x) - a.x) * (double(c.y) - a.y) -
+                 (double(b.y) - a.y) * (double(c.x) - a.x);
+  if (o == 0) return;
+  if (o < 0) std::swap(b, c);
+  const raster_edge edges[] = {{a, b}, {b, c}, {c, a}};
+  const auto covers = [&edges](double x, double y) {
+    return edges[0].covers(x, y) && edges[1].covers(x, y) &&
+           edges[2].covers(x, y);
+  };
+
+  const auto bottom = std::min({a.y, b.y, c.y});
+  const auto top = std::max({a.y, b.y, c.y});
+  const int first = std::max(ymin, int(std::ceil(bottom - 0.5f)));
+  const int last = std::min(ymax - 1, int(std::floor(top - 0.5f)));
+  for (int y = first; y <= last; ++y) {
+    const double yc = y + 0.5;
+    double left = xmax, right = xmin;
+    for (const auto& [p, q] : {std::pair{a, b}, {b, c}, {c, a}}) {
+      if ((yc < std::min(p.y, q.y)) || (yc > std::max(p.y, q.y))) continue;
+      if (p.y == q.y) {
+        left = std::min({left, double(p.x), double(q.x)});
+        right = std::max({right, double(p.x), double(q.x)});
+        continue;
+      }
+      const auto x = p.x + (yc - p.y) * (double(q.x) - p.x) / (q.y - p.y);
+      left = std::min(left, x);
+      right = std::max(right, x);
+    }
+    int x0 = std::max(xmin, int(std::floor(left - 0.5)));
+    int x1 = std::min(xmax - 1, int(std::ceil(right - 0.5)));
+    while ((x0 <= x1) && !covers(x0 + 0.5, yc)) ++x0;
+    while ((x1 >= x0) && !covers(x1 + 0.5, yc)) --x1;
+    if (x0 <= x1) f(y, x0, x1 + 1);
+  }
+}
+
+// Rasterizes the triangle for pixel coordinates in [0, width] x [0, height].
+template <typename F>
+void rasterize(point a, point b, point c, int width, int height, F&& f) {
+  rasterize(a, b, c, 0, 0, width, height, std::forward<F>(f));
+}
+
+// Per-channel prefix sums of every row of an 8-bit image. The sum over a
+// pixel span is the difference of two entries. Hence, summing a triangle
+// costs O(rows) instead of O(pixels), which makes coloring many candidate
+// triangulations of the same image cheap.
+struct row_prefix_sums {
+  // Rows are independent and are distributed over the given threads.
+  row_prefix_sums(const unsigned char* data, int w, int h, int c,
+                  size_t threads = 1)
+      : width{w}, height{h}, channels{c}, sums(size_t(w + 1) * h * c) {
+    parallel_for(height, threads, [&](size_t y, size_t) {
+      const auto in = data + y * width * channels;
+      const auto out = &sums[y * (width + 1) * channels];
+      for (int x = 0; x < width; ++x)
+        for (int k = 0; k < channels; ++k)
+          out[(x + 1) * channels + k] =
+              out[x * channels + k] + in[x * channels + k];
+    });
+  }
+
+  // Sum of channel k over the pixels [x0, x1) of row y.
+  uint32_t sum(int y, int x0, int x1, int k) const noexcept {
+    const auto row = &sums[size_t(y) * (width + 1) * channels];
+    return row[x1 * channels + k] - row[x0 * channels + k];
+  }
+
+  int width, height, channels;
+  // Row sums of 8-bit values fit into 32 bits for all practical widths.
+  std::vector<uint32_t> sums;
+};
+
+struct color_sum {
+  uint64_t channels[4]{};
+  uint64_t count{};
+};
+
+// Adds the channels and the number of the pixels whose centers the triangle
+// covers and which lie in the strip of rows [y0, y0 + strip.height) to the
+// given sum. Up to four channels are summed. Hence, images can be streamed
+// in horizontal strips whose prefix sums start at row y0.
+inline void accumulate_color_sum(color_sum& result,
+                                 const row_prefix_sums& strip, int y0, point a,
+                                 point b, point c) {
+  const int channels = std::min(strip.channels, 4);
+  rasterize(a, b, c, 0, y0, strip.width, y0 + strip.height,
+            [&](int y, int x0, int x1) {
+              result.count += x1 - x0;
+              for (int k = 0; k < channels; ++k)
+                result.channels[k] += strip.sum(y - y0, x0, x1, k);
+            });
+}
+
+// Channel sums and number of the pixels whose centers the triangle covers.
+inline color_sum triangle_color_sum(const row_prefix_sums& image, point a,
+                                    point b, point c) {
+  color_sum result{};
+  accumulate_color_sum(result, image, 0, a, b, c);
+  return result;
+}
+
+// Color sums of all triangles of an index array. The function pixel maps
+// a point index to pixel coordinates. Triangles are distributed over the
+// threads and every result is written by exactly one of them, so no
+// partial buffers have to be reduced.
+template <typename Pixel>
+std::vector<color_sum> triangle_color_sums(
+    const row_prefix_sums& image, std::span<const uint32_t> elements,
+    Pixel&& pixel, size_t threads = default_thread_count()) {
+  std::vector<color_sum> result(elements.size() / 3);
+  parallel_for(result.size(), threads, [&](size_t i, size_t) {
+    result[i] = triangle_color_sum(image, pixel(elements[3 * i]),
+                                   pixel(elements[3 * i + 1]),
+                                   pixel(elements[3 * i + 2]));
+  });
+  return result;
+}
+
+// Renders n flat-colored triangles into an RGB buffer of rows from bottom
+// to top. The function triangle(i) returns an object with the pixel
+// coordinates p[3] and the 8-bit channels color[3]. Triangles are binned
+// into square tiles by their bounding boxes and the tiles are rasterized
+// in parallel, such that every pixel is written by exactly one thread.
+// Pixels that no triangle covers keep their value.
+template <typename F>
+void render_triangles(std::span<uint8_t> rgb, int width, int height, size_t n,
+                      F&& triangle, size_t threads = default_thread_count()) {
+  constexpr int tile = 64;
+  const int tiles_x = (width + tile - 1) / tile;
+  const int tiles_y = (height + tile - 1) / tile;
+  std::vector<std::vector<uint32_t>> bins(size_t(tiles_x) * tiles_y);
+  for (size_t i = 0; i < n; ++i) {
+    const auto t = triangle(i);
+    const auto [x0, x1] = std::minmax({t.p[0].x, t.p[1].x, t.p[2].x});
+    const auto [y0, y1] = std::minmax({t.p[0].y, t.p[1].y, t.p[2].y});
+    const int tx0 = std::max(0, int(std::floor(x0)) / tile);
+    const int tx1 = std::min(tiles_x - 1, int(std::ceil(x1)) / tile);
+    const int ty0 = std::max(0, int(std::floor(y0)) / tile);
+    const int ty1 = std::min(tiles_y - 1, int(std::ceil(y1)) / tile);
+    for (int ty = ty0; ty <= ty1; ++ty)
+      for (int tx = tx0; tx <= tx1; ++tx)
+        bins[size_t(ty) * tiles_x + tx].push_back(i);
+  }
+
+  parallel_for(bins.size(), threads, [&](size_t b, size_t) {
+    const int xmin = int(b % tiles_x) * tile;
+    const int ymin = int(b / tiles_x) * tile;
+    const int xmax = std::min(xmin + tile, width);
+    const int ymax = std::min(ymin + tile, height);
+    for (const auto i : bins[b]) {
+      const auto t = triangle(i);
+      rasterize(t.p[0], t.p[1], t.p[2], xmin, ymin, xmax, ymax,
+                [&](int y, int x0, int x1) {
+                  auto out = &rgb[(size_t(y) * width + x0) * 3];
+                  for (int x = x0; x < x1; ++x, out += 3)
+                    for (int k = 0; k < 3; ++k) out[k] = t.color[k];
+                });
+    }
+  });
+}
+
+}  // namespace delaunay
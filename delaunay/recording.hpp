@@ -0,0 +1,103 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <delaunay/points.hpp>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace delaunay {
+
+// Mutation of a triangulation as it is stored in a recording.
+struct mutation {
+  enum class operation : uint8_t { add = 0, clear = 1 };
+
+  operation op;
+  point p{};
+};
+
+// Writes the mutation stream of a triangulation to a compact binary file.
+// The file starts with the magic bytes "DLNYREC1". Every record consists
+// of the operation byte followed by its payload. For add, this is the
+// point as two little-endian IEEE 754 floats. A recorder must not be
+// shared by triangulations that are mutated concurrently.
+struct mutation_recorder {
+  static constexpr char magic[8] = {'D', 'L', 'N', 'Y', 'R', 'E', 'C', '1'};
+
+  explicit mutation_recorder(const std::string& path)
+      : file{path, std::ios::binary} {
+    if (!file)
+      throw std::runtime_error{"Could not open recording file '" + path +
+                               "'!"};
+    file.write(magic, sizeof(magic));
+  }
+
+  void add(const point& p) {
+    file.put(char(mutation::operation::add));
+    write(p.x);
+    write(p.y);
+  }
+
+  void clear() { file.put(char(mutation::operation::clear)); }
+
+  void flush() { file.flush(); }
+
+  void write(float value) {
+    const auto bits = std::bit_cast<uint32_t>(value);
+    const char bytes[4] = {char(bits), char(bits >> 8), char(bits >> 16),
+                           char(bits >> 24)};
+    file.write(bytes, sizeof(bytes));
+  }
+
+  std::ofstream file;
+};
+
+inline std::vector<mutation> read_recording(const std::string& path) {
+  std::ifstream file{path, std::ios::binary};
+  char magic[sizeof(mutation_recorder::magic)];
+  if (!file.read(magic, sizeof(magic)) ||
+      !std::equal(magic, magic + sizeof(magic), mutation_recorder::magic))
+    throw std::runtime_error{"'" + path + "' is not a recording!"};
+
+  const auto read_float = [&file] {
+    unsigned char bytes[4];
+    if (!file.read(reinterpret_cast<char*>(bytes), sizeof(bytes)))
+      throw std::runtime_error{"Recording is truncated!"};
+    return std::bit_cast<float>(uint32_t(bytes[0]) | uint32_t(bytes[1]) << 8 |
+                                uint32_t(bytes[2]) << 16 |
+                                uint32_t(bytes[3]) << 24);
+  };
+
+  std::vector<mutation> result{};
+  for (int op; (op = file.get()) != std::char_traits<char>::eof();) {
+    switch (mutation::operation(op)) {
+      case mutation::operation::add: {
+        const auto x = read_float();
+        const auto y = read_float();
+        result.push_back({mutation::operation::add, {x, y}});
+      } break;
+      case mutation::operation::clear:
+        result.push_back({mutation::operation::clear});
+        break;
+      default:
+        throw std::runtime_error{"Unknown operation in recording!"};
+    }
+  }
+  return result;
+}
+
+// Applies the recorded mutations in their original order.
+template <typename Triangulation>
+void replay(Triangulation& triangulation,
+            const std::vector<mutation>& mutations) {
+  for (const auto& m : mutations) {
+    if (m.op == mutation::operation::add)
+      triangulation.add(m.p);
+    else
+      triangulation.clear();
+  }
+}
+
+}  // namespace delaunay
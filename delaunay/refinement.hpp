@@ -0,0 +1,110 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <delaunay/delaunay.hpp>
+#include <delaunay/raster.hpp>
+#include <delaunay/trace.hpp>
+#include <queue>
+#include <vector>
+
+namespace delaunay {
+
+// Triangle of the current mesh together with its color error and
+// the pixel at which it is split.
+struct refinement_candidate {
+  friend bool operator<(const refinement_candidate& x,
+                        const refinement_candidate& y) noexcept {
+    return x.error < y.error;
+  }
+
+  double error;
+  triangle t;
+  int x, y;
+};
+
+// Greedy error-driven refinement of an image tessellation. Points are given
+// in pixel coordinates and the triangulation has to contain at least one
+// triangle, for example the one spanned by the image corners. The error of
+// a triangle is the sum of squared channel deviations of its pixels from
+// their mean, which is the color the triangle gets. The triangle with the
+// largest error is split by inserting a pixel center until the number of
+// triangles reaches max_triangles or no error exceeds max_error. Only the
+// triangles of the last cavity are evaluated again. Triangles that were
+// removed stay in the queue and are skipped when popped.
+inline void refine(triangulation& mesh, const unsigned char* data,
+                   const row_prefix_sums& image, size_t max_triangles,
+                   double max_error = 0) {
+  const trace::scope scope{"refinement"};
+  const int w = image.width;
+  const int channels = image.channels;
+  // Pixels whose centers are already points must not be inserted again.
+  std::vector<bool> used(size_t(w) * image.height);
+
+  std::priority_queue<refinement_candidate> queue{};
+  const auto evaluate = [&](const triangle& t) {
+    const auto& a = mesh.points[t.pid[0]];
+    const auto& b = mesh.points[t.pid[1]];
+    const auto& c = mesh.points[t.pid[2]];
+    const auto sum = triangle_color_sum(image, a, b, c);
+    if (!sum.count) return;
+    double mean[4]{};
+    for (int k = 0; k < std::min(channels, 4); ++k)
+      mean[k] = double(sum.channels[k]) / sum.count;
+
+    refinement_candidate result{0, t, -1, -1};
+    double worst = -1, cx = 0, cy = 0;
+    rasterize(a, b, c, w, image.height, [&](int y, int x0, int x1) {
+      const auto row = data + size_t(y) * w * channels;
+      for (int x = x0; x < x1; ++x) {
+        double e = 0;
+        for (int k = 0; k < std::min(channels, 4); ++k) {
+          const auto d = row[x * channels + k] - mean[k];
+          e += d * d;
+        }
+        result.error += e;
+        cx += e * x;
+        cy += e * y;
+        if ((e > worst) && !used[size_t(y) * w + x]) {
+          worst = e;
+          result.x = x;
+          result.y = y;
+        }
+      }
+    });
+    // The worst pixel usually lies next to a vertex and would only cut off
+    // a sliver. The error-weighted centroid of the pixel centers splits the
+    // triangle in parts of similar error. Its pixel is taken if it is not
+    // already a point and the triangle covers its center, which may fail
+    // for thin triangles. Otherwise, the worst pixel is split.
+    if (result.error > 0) {
+      const int x = std::floor(cx / result.error + 0.5);
+      const int y = std::floor(cy / result.error + 0.5);
+      bool covered = false;
+      rasterize(a, b, c, x, y, x + 1, y + 1,
+                [&](int, int x0, int x1) { covered = x0 < x1; });
+      if (covered && !used[size_t(y) * w + x]) {
+        result.x = x;
+        result.y = y;
+      }
+    }
+    if ((result.x >= 0) && (result.error > max_error)) queue.push(result);
+  };
+  for (const auto& t : mesh.triangles) evaluate(t);
+
+  while (!queue.empty() && (mesh.triangles.size() < max_triangles)) {
+    const auto candidate = queue.top();
+    queue.pop();
+    if (!mesh.triangles.contains(candidate.t)) continue;
+    used[size_t(candidate.y) * w + candidate.x] = true;
+    mesh.add({candidate.x + 0.5f, candidate.y + 0.5f});
+    // The new triangles are spanned by the boundary edges of the cavity.
+    const size_t pid = mesh.points.size() - 1;
+    for (const auto& e : mesh.polygon)
+      if ((e.pid[0] != triangulation::ghost) &&
+          (e.pid[1] != triangulation::ghost))
+        evaluate({e.pid[0], e.pid[1], pid});
+  }
+}
+
+}  // namespace delaunay
@@ -0,0 +1,51 @@
+#include <delaunay/benchmark.hpp>
+#include <delaunay/delaunay.hpp>
+#include <delaunay/recording.hpp>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Replays a recorded mutation stream with timing, such that slow sessions
+// can be reproduced and profiled offline. Record a session by setting
+// DELAUNAY_RECORD to an output path when running main. Latencies are
+// measured per mutation, that is for every addition and every clear.
+int main(int argc, char** argv) {
+  using namespace std;
+  namespace bench = delaunay::benchmark;
+
+  if (argc < 2)
+    throw invalid_argument{"Usage: replay <recording> [repetitions]"};
+  const string path{argv[1]};
+  const size_t repetitions = (argc > 2) ? stoul(argv[2]) : 1;
+
+  const auto mutations = delaunay::read_recording(path);
+  size_t additions = 0;
+  for (const auto& m : mutations)
+    additions += (m.op == delaunay::mutation::operation::add);
+
+  for (size_t i = 0; i < repetitions; ++i) {
+    cout << bench::isolated([&] {
+      delaunay::triangulation triangulation{};
+      delaunay::latency_recorder recorder{};
+      triangulation.latency = &recorder;
+      const auto t = bench::seconds(
+          [&] { delaunay::replay(triangulation, mutations); });
+      const auto s = recorder.snapshot();
+
+      ostringstream json{};
+      json << "{\"recording\": " << bench::json_string(path)
+           << ", \"mutations\": " << mutations.size()
+           << ", \"additions\": " << additions
+           << ", \"triangles\": " << triangulation.triangles.size()
+           << ", \"seconds\": " << t
+           << ", \"mutations_per_second\": " << mutations.size() / t
+           << ", \"peak_rss_bytes\": " << bench::peak_rss()
+           << ", \"mutation_latency_ns\": {\"p50\": " << s.p50()
+           << ", \"p99\": " << s.p99() << ", \"p999\": " << s.p999()
+           << ", \"max\": " << s.max << "}}";
+      return json.str();
+    }) << '\n';
+  }
+}
@@ -0,0 +1,110 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <delaunay/parallel.hpp>
+#include <delaunay/points.hpp>
+#include <random>
+#include <vector>
+
+namespace delaunay {
+
+// Sobel gradient magnitude of the channel mean of an 8-bit image.
+// Borders are handled by clamping the coordinates. Rows are distributed
+// over the threads and the inner loops have no branches, such that
+// they are vectorized.
+inline std::vector<float> gradient_magnitude(const unsigned char* data, int w,
+                                             int h, int c,
+                                             size_t threads = 1) {
+  std::vector<float> gray(size_t(w) * h);
+  const int channels = std::min(c, 3);
+  parallel_for(h, threads, [&](size_t y, size_t) {
+    const auto in = data + y * w * c;
+    const auto out = &gray[y * w];
+    for (int x = 0; x < w; ++x) {
+      float sum = 0;
+      for (int k = 0; k < channels; ++k) sum += in[x * c + k];
+      out[x] = sum / channels;
+    }
+  });
+
+  std::vector<float> result(size_t(w) * h);
+  parallel_for(h, threads, [&](size_t y, size_t) {
+    const auto top = &gray[size_t(std::max(int(y) - 1, 0)) * w];
+    const auto mid = &gray[y * w];
+    const auto bottom = &gray[size_t(std::min(int(y) + 1, h - 1)) * w];
+    const auto out = &result[y * w];
+    const auto at = [&](int x) {
+      const int l = std::max(x - 1, 0);
+      const int r = std::min(x + 1, w - 1);
+      const auto gx = (top[r] + 2 * mid[r] + bottom[r]) -
+                      (top[l] + 2 * mid[l] + bottom[l]);
+      const auto gy = (bottom[l] + 2 * bottom[x] + bottom[r]) -
+                      (top[l] + 2 * top[x] + top[r]);
+      return std::sqrt(gx * gx + gy * gy);
+    };
+    out[0] = at(0);
+    for (int x = 1; x < w - 1; ++x) {
+      const auto gx = (top[x + 1] + 2 * mid[x + 1] + bottom[x + 1]) -
+                      (top[x - 1] + 2 * mid[x - 1] + bottom[x - 1]);
+      const auto gy = (bottom[x - 1] + 2 * bottom[x] + bottom[x + 1]) -
+                      (top[x - 1] + 2 * top[x] + top[x + 1]);
+      out[x] = std::sqrt(gx * gx + gy * gy);
+    }
+    if (w > 1) out[w - 1] = at(w - 1);
+  });
+  return result;
+}
+
+// Draws n points with a density proportional to the given pixel weights
+// plus a uniform floor, such that flat regions are not left empty.
+// Points are jittered inside their pixel and given in pixel coordinates.
+// Pixels are found by binary searches in the cumulative distribution of
+// the rows and in the prefix sums of the chosen row. Samples are drawn in
+// fixed blocks with one generator per block. Hence, the result only
+// depends on the seed and not on the number of threads.
+inline std::vector<point> importance_samples(const std::vector<float>& weights,
+                                             int w, int h, size_t n,
+                                             uint64_t seed, float floor = 0.05f,
+                                             size_t threads = 1) {
+  double mean = 0;
+  for (const auto x : weights) mean += x;
+  mean /= weights.size();
+  const auto uniform = float(floor * mean) + 1e-6f;
+
+  // Inclusive prefix sums of every row and the distribution of the rows.
+  std::vector<double> cumulative(weights.size());
+  std::vector<double> rows(h);
+  parallel_for(h, threads, [&](size_t y, size_t) {
+    double sum = 0;
+    for (int x = 0; x < w; ++x) {
+      sum += weights[y * w + x] + uniform;
+      cumulative[y * w + x] = sum;
+    }
+    rows[y] = sum;
+  });
+  for (int y = 1; y < h; ++y) rows[y] += rows[y - 1];
+
+  constexpr size_t block = 1024;
+  std::vector<point> result(n);
+  parallel_for((n + block - 1) / block, threads, [&](size_t b, size_t) {
+    std::mt19937_64 rng{seed ^ (0x9e3779b97f4a7c15ull * (b + 1))};
+    std::uniform_real_distribution<double> total{0, rows.back()};
+    std::uniform_real_distribution<float> jitter{0, 1};
+    for (size_t i = b * block; i < std::min(n, (b + 1) * block); ++i) {
+      auto u = total(rng);
+      const int y =
+          std::min(int(std::upper_bound(rows.begin(), rows.end(), u) -
+                       rows.begin()),
+                   h - 1);
+      if (y) u -= rows[y - 1];
+      const auto row = cumulative.begin() + size_t(y) * w;
+      const int x =
+          std::min(int(std::upper_bound(row, row + w, u) - row), w - 1);
+      result[i] = {x + jitter(rng), y + jitter(rng)};
+    }
+  });
+  return result;
+}
+
+}  // namespace delaunay
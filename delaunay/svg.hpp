@@ -0,0 +1,336 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <delaunay/parallel.hpp>
+#include <delaunay/points.hpp>
+#include <fstream>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+namespace delaunay {
+
+using svg_color = std::array<uint8_t, 3>;
+
+// Flat-colored triangle in SVG coordinates with y pointing down.
+struct svg_triangle {
+  point p[3];
+  svg_color color;
+};
+
+// Growing character buffer with std::to_chars-based number formatting.
+// It is reused between chunks, so that formatting does not allocate
+// once the capacity has been reached.
+struct svg_buffer {
+  void clear() noexcept { size = 0; }
+
+  char* reserve(size_t n) {
+    if (size + n > data.size())
+      data.resize(std::max(2 * data.size(), size + n));
+    return data.data() + size;
+  }
+
+  void append(std::string_view s) {
+    std::copy(s.begin(), s.end(), reserve(s.size()));
+    size += s.size();
+  }
+
+  // Coordinates are rounded to integers unless digits are requested.
+  // The reserved space grows until the formatted number fits.
+  void number(float x, int precision) {
+    for (size_t max_size = 64;; max_size *= 2) {
+      const auto first = reserve(max_size);
+      const auto r = (precision > 0)
+                         ? std::to_chars(first, first + max_size, x,
+                                         std::chars_format::fixed, precision)
+                         : std::to_chars(first, first + max_size,
+                                         long(std::lround(x)));
+      if (r.ec == std::errc{}) {
+        size = r.ptr - data.data();
+        return;
+      }
+    }
+  }
+
+  void number(size_t x) {
+    constexpr size_t max_size = 24;
+    const auto first = reserve(max_size);
+    size = std::to_chars(first, first + max_size, x).ptr - data.data();
+  }
+
+  void color(const svg_color& rgb) {
+    constexpr char hex[] = "0123456789abcdef";
+    auto out = reserve(7);
+    *out++ = '#';
+    for (const auto c : rgb) {
+      *out++ = hex[c >> 4];
+      *out++ = hex[c & 15];
+    }
+    size += 7;
+  }
+
+  void triangle(const svg_triangle& t, int precision) {
+    append("<polygon color=\"");
+    color(t.color);
+    append("\" points=\"");
+    for (size_t i = 0; i < 3; ++i) {
+      if (i) append(" ");
+      number(t.p[i].x, precision);
+      append(",");
+      number(t.p[i].y, precision);
+    }
+    append("\"/>\n");
+  }
+
+  std::string_view view() const noexcept { return {data.data(), size}; }
+
+  std::vector<char> data{};
+  size_t size{};
+};
+
+// Writes n triangles given by triangle(i) as an SVG image. Every polygon
+// only carries its color, fill and stroke refer to it via currentColor.
+// Fixed-size chunks are formatted in parallel into reused buffers and
+// written in order, so the output does not depend on the thread count.
+template <typename F>
+void write_svg(const std::string& path, int width, int height, size_t n,
+               F&& triangle, int precision = 0, size_t threads = 1) {
+  std::ofstream file{path, std::ios::binary};
+  if (!file) throw std::runtime_error("Could not open '" + path + "'!");
+
+  svg_buffer header{};
+  header.append("<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"");
+  header.number(width, 0);
+  header.append("\" height=\"");
+  header.number(height, 0);
+  header.append(
+      "\">\n<style>polygon{fill:currentColor;stroke:currentColor;"
+      "stroke-width:0.1}</style>\n");
+  file.write(header.data.data(), header.size);
+
+  constexpr size_t chunk = 4096;
+  const size_t chunks = (n + chunk - 1) / chunk;
+  threads = std::max(size_t{1}, threads);
+  std::vector<svg_buffer> buffers(threads);
+  for (size_t first = 0; first < chunks; first += threads) {
+    const size_t count = std::min(threads, chunks - first);
+    parallel_for(count, threads, [&](size_t c, size_t) {
+      auto& buffer = buffers[c];
+      buffer.clear();
+      const size_t begin = (first + c) * chunk;
+      for (size_t i = begin; i < std::min(n, begin + chunk); ++i)
+        buffer.triangle(triangle(i), precision);
+    });
+    for (size_t c = 0; c < count; ++c)
+      file.write(buffers[c].data.data(), buffers[c].size);
+  }
+  file << "</svg>\n";
+  if (!file) throw std::runtime_error("Could not write '" + path + "'!");
+}
+
+// Writes the triangles of an index array as one path per color. Points are
+// given in SVG coordinates and every triangle has its own color. First,
+// edge-adjacent triangles are merged into clusters, as long as the channels
+// of every member stay within the tolerance of the mean color of the
+// cluster, which all members get. Only the boundary edges of the clusters
+// are written. They are chained into closed loops, which keep the
+// orientation of the triangles, such that holes are handled by the nonzero
+// fill rule. Then, all clusters of the same color
+// are written into one path that refers to a shared style class.
+inline void write_svg_paths(const std::string& path, int width, int height,
+                            std::span<const point> points,
+                            std::span<const uint32_t> elements,
+                            std::span<const svg_color> colors,
+                            int tolerance = 0, int precision = 0) {
+  const size_t n = elements.size() / 3;
+
+  // Undirected edges that occur twice are shared by adjacent triangles.
+  struct triangle_edge {
+    uint64_t key;
+    uint32_t triangle;
+  };
+  std::vector<triangle_edge> edges(elements.size());
+  for (size_t i = 0; i < elements.size(); ++i) {
+    const uint64_t a = elements[i];
+    const uint64_t b = elements[(i % 3 == 2) ? i - 2 : i + 1];
+    edges[i] = {(std::min(a, b) << 32) | std::max(a, b), uint32_t(i / 3)};
+  }
+  std::sort(edges.begin(), edges.end(), [](const auto& x, const auto& y) {
+    return (x.key < y.key) || ((x.key == y.key) && (x.triangle < y.triangle));
+  });
+
+  // Union-find with the smallest triangle index as the representative.
+  // Every representative keeps the channel sums, size and channel range of
+  // its cluster. Two clusters are only merged if no member would differ by
+  // more than the tolerance from the rounded mean of the merged cluster.
+  // Hence, clusters cannot drift along slow gradients.
+  struct cluster {
+    svg_color mean() const noexcept {
+      svg_color result{};
+      for (size_t k = 0; k < 3; ++k)
+        result[k] = uint8_t((sum[k] + count / 2) / count);
+      return result;
+    }
+
+    uint64_t sum[3];
+    uint64_t count;
+    svg_color lo, hi;
+  };
+  std::vector<uint32_t> parent(n);
+  std::iota(parent.begin(), parent.end(), 0);
+  std::vector<cluster> clusters(n);
+  for (size_t i = 0; i < n; ++i)
+    clusters[i] = {{colors[i][0], colors[i][1], colors[i][2]},
+                   1,
+                   colors[i],
+                   colors[i]};
+  const auto find = [&](uint32_t i) {
+    while (parent[i] != i) i = parent[i] = parent[parent[i]];
+    return i;
+  };
+  for (size_t i = 0; i + 1 < edges.size(); ++i) {
+    if (edges[i].key != edges[i + 1].key) continue;
+    const auto a = find(edges[i].triangle);
+    const auto b = find(edges[i + 1].triangle);
+    if (a == b) continue;
+    const auto& x = clusters[a];
+    const auto& y = clusters[b];
+    cluster merged{};
+    merged.count = x.count + y.count;
+    for (size_t k = 0; k < 3; ++k) {
+      merged.sum[k] = x.sum[k] + y.sum[k];
+      merged.lo[k] = std::min(x.lo[k], y.lo[k]);
+      merged.hi[k] = std::max(x.hi[k], y.hi[k]);
+    }
+    const auto mean = merged.mean();
+    bool similar = true;
+    for (size_t k = 0; k < 3; ++k)
+      similar &= (mean[k] - merged.lo[k] <= tolerance) &&
+                 (merged.hi[k] - mean[k] <= tolerance);
+    if (!similar) continue;
+    parent[std::max(a, b)] = std::min(a, b);
+    clusters[std::min(a, b)] = merged;
+  }
+
+  // Mean color of every cluster, stored at its representative.
+  std::vector<svg_color> cluster_color(n);
+  for (uint32_t i = 0; i < n; ++i)
+    if (find(i) == i) cluster_color[i] = clusters[i].mean();
+
+  // Directed boundary edges sorted by cluster and origin.
+  struct boundary_edge {
+    uint32_t cluster, from, to;
+    bool used;
+  };
+  std::vector<boundary_edge> boundary{};
+  for (size_t i = 0; i < edges.size(); ++i) {
+    const bool shared =
+        ((i > 0) && (edges[i - 1].key == edges[i].key) &&
+         (find(edges[i - 1].triangle) == find(edges[i].triangle))) ||
+        ((i + 1 < edges.size()) && (edges[i + 1].key == edges[i].key) &&
+         (find(edges[i + 1].triangle) == find(edges[i].triangle)));
+    if (shared) continue;
+    // Recover the direction from the triangle.
+    const auto t = edges[i].triangle;
+    const uint32_t u = edges[i].key >> 32;
+    const uint32_t v = uint32_t(edges[i].key);
+    uint32_t from = u, to = v;
+    for (size_t k = 0; k < 3; ++k)
+      if ((elements[3 * t + k] == v) && (elements[3 * t + (k + 1) % 3] == u))
+        std::swap(from, to);
+    boundary.push_back({find(t), from, to, false});
+  }
+  const auto boundary_order = [](const auto& x, const auto& y) {
+    return (x.cluster < y.cluster) ||
+           ((x.cluster == y.cluster) && (x.from < y.from));
+  };
+  std::sort(boundary.begin(), boundary.end(), boundary_order);
+
+  // Clusters grouped by their color.
+  std::vector<uint32_t> roots{};
+  for (uint32_t i = 0; i < n; ++i)
+    if (find(i) == i) roots.push_back(i);
+  std::stable_sort(roots.begin(), roots.end(),
+                   [&](uint32_t x, uint32_t y) {
+                     return cluster_color[x] < cluster_color[y];
+                   });
+
+  std::ofstream file{path, std::ios::binary};
+  if (!file) throw std::runtime_error("Could not open '" + path + "'!");
+  svg_buffer buffer{};
+  buffer.append("<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"");
+  buffer.number(width, 0);
+  buffer.append("\" height=\"");
+  buffer.number(height, 0);
+  buffer.append(
+      "\">\n<style>path{fill:currentColor;stroke:currentColor;"
+      "stroke-width:0.1}");
+  size_t classes = 0;
+  for (size_t i = 0; i < roots.size(); ++i) {
+    const auto& color = cluster_color[roots[i]];
+    if (i && (color == cluster_color[roots[i - 1]])) continue;
+    buffer.append("\n.c");
+    buffer.number(classes++);
+    buffer.append("{color:");
+    buffer.color(color);
+    buffer.append("}");
+  }
+  buffer.append("</style>\n");
+
+  const auto vertex = [&](uint32_t pid) {
+    buffer.number(points[pid].x, precision);
+    buffer.append(",");
+    buffer.number(points[pid].y, precision);
+  };
+  classes = 0;
+  for (size_t i = 0; i < roots.size(); ++i) {
+    const auto root = roots[i];
+    if (!i || (cluster_color[root] != cluster_color[roots[i - 1]])) {
+      if (i) buffer.append("\"/>\n");
+      buffer.append("<path class=\"c");
+      buffer.number(classes++);
+      buffer.append("\" d=\"");
+    }
+    const auto range = std::equal_range(
+        boundary.begin(), boundary.end(), boundary_edge{root, 0, 0, false},
+        [](const auto& x, const auto& y) { return x.cluster < y.cluster; });
+    for (auto start = range.first; start != range.second; ++start) {
+      if (start->used) continue;
+      // Follow unused edges until the loop is closed. At vertices where
+      // the cluster touches itself, any outgoing edge leads to a valid
+      // decomposition into loops.
+      buffer.append("M");
+      vertex(start->from);
+      start->used = true;
+      auto to = start->to;
+      while (to != start->from) {
+        buffer.append(" ");
+        vertex(to);
+        auto next = std::lower_bound(range.first, range.second,
+                                     boundary_edge{root, to, 0, false},
+                                     boundary_order);
+        while (next->used) ++next;
+        next->used = true;
+        to = next->to;
+      }
+      buffer.append("Z");
+    }
+    if (buffer.size > (size_t{1} << 20)) {
+      file.write(buffer.data.data(), buffer.size);
+      buffer.clear();
+    }
+  }
+  if (!roots.empty()) buffer.append("\"/>\n");
+  buffer.append("</svg>\n");
+  file.write(buffer.data.data(), buffer.size);
+  if (!file) throw std::runtime_error("Could not write '" + path + "'!");
+}
+
+}  // namespace delaunay
@@ -1,9 +1,9 @@
-#include <fstream>
-#include <iomanip>
+#include <functional>
+#include <future>
 #include <iostream>
-#include <random>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <vector>
 //
 #include <glbinding/gl/gl.h>
@@ -17,126 +17,72 @@ using namespace gl;
 //
 #include <glm/ext.hpp>
 //
-#include <delaunay/delaunay.hpp>
-#include <delaunay/geometry.hpp>
-//
-extern "C" {
-#include "stb_image.h"
-}
-
-struct vertex {
-  float x, y;
-  float r, g, b;
-  float u, v;
-};
+#include <delaunay/tessellation.hpp>
 
-struct accum {
-  float color[4]{};
-  unsigned int count{};
-};
+using delaunay::tessellation;
+using vertex = tessellation::vertex;
 
 float width = 500;
 float height = 500;
 glm::vec2 fov{width / height, 1.0f};
 
+// Loads, samples and triangulates an image on a worker thread.
+tessellation prepare(const char* path,
+                     const delaunay::tessellation_options& opts) {
+  auto result = delaunay::decode_image(path, opts);
+  delaunay::sample_points(result, opts);
+  delaunay::triangulate_points(result);
+  return result;
+}
+
+// Usage: tessellation [options] <image>...
+// Every image is written to output.svg or, for several images, to
+// output-<k>.svg. The first one is shown afterwards. In headless mode,
+// it is rendered to output.<format> or output-<k>.<format> instead.
+// The options are listed in delaunay::tessellation_usage.
 int main(int argc, char** argv) {
   using namespace std;
 
-  int image_w, image_h, image_channels;
+  delaunay::tessellation_options opts{};
+  vector<const char*> paths{};
+  for (int i = 1; i < argc; ++i) {
+    if (opts.parse(i, argc, argv)) continue;
+    if (string_view{argv[i]}.starts_with("--"))
+      throw invalid_argument{"Unknown argument '"s + argv[i] + "'!\n" +
+                             delaunay::tessellation_usage};
+    paths.push_back(argv[i]);
+  }
+  if (paths.empty())
+    throw invalid_argument{"Usage: tessellation [options] <image>...\n"s +
+                           delaunay::tessellation_usage};
+  opts.check();
   stbi_set_flip_vertically_on_load(true);
-  unsigned char* image_data =
-      stbi_load(argv[1], &image_w, &image_h, &image_channels, 0);
-  if (image_data) {
-    cout << "resolution = " << image_w << " x " << image_h << " x "
-         << image_channels << "\n";
-  } else {
-    throw runtime_error("Could not load the given image!");
+  const size_t threads = delaunay::default_thread_count();
+
+  // Loading and triangulating the next image overlaps
+  // with the parallel coloring of the current one.
+  tessellation shown{};
+  auto next = async(launch::async, prepare, paths[0], cref(opts));
+  for (size_t i = 0; i < paths.size(); ++i) {
+    auto t = next.get();
+    if (i + 1 < paths.size())
+      next = async(launch::async, prepare, paths[i + 1], cref(opts));
+    cout << paths[i] << ": resolution = " << t.image_w << " x " << t.image_h
+         << " x " << t.image_channels << ", triangles = "
+         << t.elements.size() / 3 << "\n";
+    delaunay::color_triangles(t, opts, threads);
+    delaunay::write_outputs(
+        t, (paths.size() == 1) ? "output"s : "output-" + to_string(i), opts,
+        threads);
+    if (opts.headless.empty() && (i == 0)) shown = move(t);
   }
+  // Batch jobs without display never initialize GLFW.
+  if (!opts.headless.empty()) return 0;
 
-  width = image_w;
-  height = image_h;
+  width = shown.image_w;
+  height = shown.image_h;
   fov.x = width / height;
-
-  mt19937 rng{random_device{}()};
-  uniform_real_distribution<float> dist{0, 1};
-
-  constexpr size_t samples = 1000;
-  vector<glm::vec2> points(samples);
-  for (auto& p : points) p = glm::vec2{fov.x * dist(rng), dist(rng)};
-  points[0].x = 0;
-  points[0].y = 0;
-  points[1].x = fov.x;
-  points[1].y = 0;
-  points[2].x = fov.x;
-  points[2].y = 1;
-  points[3].x = 0;
-  points[3].y = 1;
-
-  delaunay::triangulation triangulation{};
-  const auto elements = triangulation.triangle_data(points);
-
-  vector<accum> accum_buffer(elements.size() / 3);
-  for (int i = 0; i < image_h; ++i) {
-    for (int j = 0; j < image_w; ++j) {
-      const auto x = float(j) / (image_w - 1) * fov.x + 0.5f / image_h;
-      const auto y = float(i) / (image_h - 1) + 0.5f / image_h;
-
-      size_t index = 0;
-      for (size_t k = 0; k < elements.size(); k += 3, ++index) {
-        if (geometry::intersection(
-                {{{points[elements[k + 0]].x, points[elements[k + 0]].y},
-                  {points[elements[k + 1]].x, points[elements[k + 1]].y},
-                  {points[elements[k + 2]].x, points[elements[k + 2]].y}}},
-                {x, y})) {
-          break;
-        }
-      }
-      if (index == elements.size() / 3) continue;
-
-      accum_buffer[index].count += 1;
-      for (int k = 0; k < image_channels; ++k) {
-        accum_buffer[index].color[k] +=
-            float(image_data[image_channels * (i * image_w + j) + k]) / 255.0f;
-      }
-    }
-  }
-
-  vector<vertex> vertices(elements.size());
-  int index = 0;
-  for (size_t i = 0; i < vertices.size(); i += 3, ++index) {
-    for (size_t j = 0; j < 3; ++j) {
-      vertices[i + j].x = points[elements[i + j]].x;
-      vertices[i + j].y = points[elements[i + j]].y;
-
-      vertices[i + j].r =
-          accum_buffer[index].color[0] / accum_buffer[index].count;
-      vertices[i + j].g =
-          accum_buffer[index].color[1] / accum_buffer[index].count;
-      vertices[i + j].b =
-          accum_buffer[index].color[2] / accum_buffer[index].count;
-
-      vertices[i + j].u = vertices[i + j].x / fov.x;
-      vertices[i + j].v = vertices[i + j].y;
-    }
-  }
-
-  // Generate SVG.
-  fstream svg_file{"output.svg", ios::out};
-  svg_file << "<svg height=\"" << image_h << "\" width=\"" << image_w << "\">";
-  index = 0;
-  for (size_t i = 0; i < vertices.size(); i += 3, ++index) {
-    svg_file << "<polygon points=\"";
-    for (size_t j = 0; j < 3; ++j) {
-      svg_file << (vertices[i + j].x * image_h) << ','
-               << ((1.0f - vertices[i + j].y) * image_h) << ' ';
-    }
-    svg_file << "\" style=\"fill:rgb(" << (vertices[i].r * 255.0f) << ", "
-             << (vertices[i].g * 255.0f) << ", " << (vertices[i].b * 255.0f)
-             << ");stroke:rgb(" << (vertices[i].r * 255.0f) << ", "
-             << (vertices[i].g * 255.0f) << ", " << (vertices[i].b * 255.0f)
-             << ");stroke-width:0.1\" />";
-  }
-  svg_file << "</svg>" << flush;
+  const auto& vertices = shown.vertices;
 
   // Run the program.
   glfwSetErrorCallback([](int error, const char* description) {
@@ -191,7 +137,7 @@ int main(int argc, char** argv) {
   //     break;
   // }
   // glGenerateMipmap(GL_TEXTURE_2D);
-  stbi_image_free(image_data);
+  shown.image_data.reset();
 
   auto vertex_shader = glCreateShader(GL_VERTEX_SHADER);
   const char* vertex_shader_text =
@@ -0,0 +1,438 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <delaunay/delaunay.hpp>
+#include <delaunay/image.hpp>
+#include <delaunay/raster.hpp>
+#include <delaunay/refinement.hpp>
+#include <delaunay/sampling.hpp>
+#include <delaunay/svg.hpp>
+#include <delaunay/trace.hpp>
+#include <glm/glm.hpp>
+#include <memory>
+#include <numeric>
+#include <optional>
+#include <random>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+//
+extern "C" {
+#include "stb_image.h"
+}
+
+// Stages of the image tessellation that do not need a window. Every stage
+// takes the result of the previous one, such that images can be processed
+// one after another or in a pipeline.
+namespace delaunay {
+
+// Image together with its triangulation. Points are given
+// in [0, image_w / image_h] x [0, 1] and vertices carry the colors.
+struct tessellation {
+  struct vertex {
+    float x, y;
+    float r, g, b;
+    float u, v;
+  };
+
+  std::string path{};
+  int image_w{}, image_h{}, image_channels{};
+  std::unique_ptr<unsigned char, void (*)(void*)> image_data{nullptr,
+                                                             stbi_image_free};
+  std::vector<glm::vec2> points{};
+  std::vector<uint32_t> elements{};
+  std::vector<vertex> vertices{};
+};
+
+// Random points are sampled unless a triangle budget for the
+// error-driven refinement is given. Importance sampling places
+// the points by the gradient magnitude of the image.
+struct tessellation_options {
+  // Consumes the option at argv[i] and its value. Returns false
+  // for arguments that are no options of the tessellation.
+  bool parse(int& i, int argc, char** argv);
+  // Throws std::invalid_argument for inconsistent options.
+  void check() const;
+
+  size_t samples{1000};
+  bool importance{};
+  uint64_t seed{std::random_device{}()};
+  size_t adaptive_triangles{};
+  double max_error{};
+  // Decimal digits of the SVG coordinates.
+  int svg_precision{};
+  // Adjacent triangles are merged into paths as long as their color
+  // channels stay within this tolerance of the mean color of the path.
+  // Negative values disable merging.
+  int merge_tolerance{-1};
+  // Image format of the headless output. If given, no window is opened.
+  std::string headless{};
+  // Rows per strip for streaming binary PPM images. If given, the image is
+  // never held in memory and only random sampling is available.
+  int strip_rows{};
+};
+
+// Command-line description of the options for the usage messages.
+constexpr const char* tessellation_usage =
+    "  --samples <n>          number of random points, including the corners\n"
+    "  --importance           sample by the gradient magnitude of the image\n"
+    "  --seed <seed>          seed of the random points\n"
+    "  --adaptive <triangles> refine by color error up to the triangle budget\n"
+    "  --max-error <e>        stop the refinement once no triangle has a\n"
+    "                         larger sum of squared channel deviations\n"
+    "  --svg-precision <d>    decimal digits of the SVG coordinates, 0 to 9\n"
+    "  --merge <tolerance>    merge adjacent triangles of similar color\n"
+    "  --headless <bmp|ppm>   render on the CPU instead of opening a window\n"
+    "  --strip <rows>         stream binary PPM images in strips of rows\n";
+
+inline bool tessellation_options::parse(int& i, int argc, char** argv) {
+  const std::string arg{argv[i]};
+  const bool value = i + 1 < argc;
+  if ((arg == "--samples") && value)
+    samples = std::stoul(argv[++i]);
+  else if (arg == "--importance")
+    importance = true;
+  else if ((arg == "--seed") && value)
+    seed = std::stoull(argv[++i]);
+  else if ((arg == "--adaptive") && value)
+    adaptive_triangles = std::stoul(argv[++i]);
+  else if ((arg == "--max-error") && value)
+    max_error = std::stod(argv[++i]);
+  else if ((arg == "--svg-precision") && value)
+    svg_precision = std::stoi(argv[++i]);
+  else if ((arg == "--merge") && value)
+    merge_tolerance = std::stoi(argv[++i]);
+  else if ((arg == "--headless") && value)
+    headless = argv[++i];
+  else if ((arg == "--strip") && value)
+    strip_rows = std::stoi(argv[++i]);
+  else
+    return false;
+  return true;
+}
+
+inline void tessellation_options::check() const {
+  if (!headless.empty() && (headless != "bmp") && (headless != "ppm"))
+    throw std::invalid_argument{"Unknown image format '" + headless + "'!"};
+  if ((svg_precision < 0) || (svg_precision > 9))
+    throw std::invalid_argument{"SVG precision must be in [0, 9]!"};
+  if ((strip_rows < 0) || (strip_rows && (importance || adaptive_triangles)))
+    throw std::invalid_argument{
+        "Strips need a positive size and random sampling!"};
+}
+
+// 8-bit channels of the color of a vertex.
+inline svg_color quantized_color(const tessellation::vertex& v) {
+  const auto quantize = [](float c) {
+    return uint8_t(std::clamp(std::lround(c * 255.0f), 0l, 255l));
+  };
+  return {quantize(v.r), quantize(v.g), quantize(v.b)};
+}
+
+// Decodes the image. In strip mode, only the size is read.
+inline tessellation decode_image(const std::string& path,
+                                 const tessellation_options& opts) {
+  const trace::scope stage{"image load"};
+  tessellation result{};
+  result.path = path;
+  if (opts.strip_rows) {
+    const ppm_reader reader{path};
+    result.image_w = reader.width;
+    result.image_h = reader.height;
+    result.image_channels = reader.channels;
+  } else {
+    result.image_data.reset(stbi_load(path.c_str(), &result.image_w,
+                                      &result.image_h,
+                                      &result.image_channels, 0));
+    if (!result.image_data)
+      throw std::runtime_error("Could not load the image '" + path + "'!");
+  }
+  return result;
+}
+
+// Places the points. The adaptive refinement builds
+// the triangulation while placing them.
+inline void sample_points(tessellation& t, const tessellation_options& opts,
+                          size_t threads = default_thread_count()) {
+  const float aspect = float(t.image_w) / t.image_h;
+  const float h = t.image_h;
+
+  if (opts.adaptive_triangles) {
+    const trace::scope stage{"refinement"};
+    const float w = t.image_w;
+    triangulation mesh{};
+    for (const auto& p : {point{0, 0}, {w, 0}, {w, h}, {0, h}}) mesh.add(p);
+    const row_prefix_sums image{t.image_data.get(), t.image_w, t.image_h,
+                                t.image_channels, threads};
+    refine(mesh, t.image_data.get(), image, opts.adaptive_triangles,
+           opts.max_error);
+    t.points.clear();
+    for (const auto& p : mesh.points)
+      t.points.push_back(glm::vec2{p.x / h, p.y / h});
+    t.elements = mesh.triangle_data();
+    return;
+  }
+
+  const trace::scope stage{"sampling"};
+  auto& points = t.points;
+  points.resize(std::max(opts.samples, size_t{4}));
+  if (opts.importance) {
+    const auto gradient = gradient_magnitude(
+        t.image_data.get(), t.image_w, t.image_h, t.image_channels, threads);
+    const auto samples =
+        importance_samples(gradient, t.image_w, t.image_h, points.size() - 4,
+                           opts.seed, 0.05f, threads);
+    for (size_t i = 0; i < samples.size(); ++i)
+      points[i + 4] = glm::vec2{samples[i].x / h, samples[i].y / h};
+  } else {
+    std::mt19937 rng{opts.seed};
+    std::uniform_real_distribution<float> dist{0, 1};
+    for (auto& p : points) p = glm::vec2{aspect * dist(rng), dist(rng)};
+  }
+  points[0].x = 0;
+  points[0].y = 0;
+  points[1].x = aspect;
+  points[1].y = 0;
+  points[2].x = aspect;
+  points[2].y = 1;
+  points[3].x = 0;
+  points[3].y = 1;
+}
+
+// Triangulates the points unless the sampling already did.
+inline void triangulate_points(tessellation& t) {
+  if (!t.elements.empty()) return;
+  const trace::scope stage{"triangulation"};
+  basic_triangulation triangulation{std::span{t.points}};
+  triangulation.build();
+  t.elements = triangulation.triangle_data();
+}
+
+// Row and column of the pixel under the centroid of triangle i, clamped to
+// the image.
+inline std::pair<int, int> centroid_pixel(const tessellation& t, size_t i) {
+  float x = 0, y = 0;
+  for (size_t j = 3 * i; j < 3 * i + 3; ++j) {
+    x += t.points[t.elements[j]].x;
+    y += t.points[t.elements[j]].y;
+  }
+  const auto at = [&](float c, int size) {
+    return std::clamp(int(std::floor(c * t.image_h / 3)), 0, size - 1);
+  };
+  return {at(y, t.image_h), at(x, t.image_w)};
+}
+
+// Color of a single pixel with the given number of channels.
+inline color_sum pixel_color(const uint8_t* pixel, int channels) {
+  color_sum result{};
+  for (int k = 0; k < std::min(channels, 4); ++k) result.channels[k] = pixel[k];
+  result.count = 1;
+  return result;
+}
+
+// Sets the vertices of triangle i to the mean color of its pixels.
+// Triangles that cover no pixel center take the given fallback color.
+// Gray images are mapped to all three channels.
+inline void set_color(tessellation& t, size_t i, const color_sum& sum,
+                      const color_sum& fallback) {
+  const float aspect = float(t.image_w) / t.image_h;
+  const auto& s = sum.count ? sum : fallback;
+  const auto channel = [&](int c) {
+    const auto k = (t.image_channels < 3) ? 0 : c;
+    return s.count ? s.channels[k] / 255.0f / s.count : 0.0f;
+  };
+  for (size_t j = 3 * i; j < 3 * i + 3; ++j) {
+    auto& v = t.vertices[j];
+    v.x = t.points[t.elements[j]].x;
+    v.y = t.points[t.elements[j]].y;
+    v.r = channel(0);
+    v.g = channel(1);
+    v.b = channel(2);
+    v.u = v.x / aspect;
+    v.v = v.y;
+  }
+}
+
+inline void color_triangles(tessellation& t, size_t threads) {
+  // The prefix sums only depend on the image. Once they exist, coloring
+  // a triangulation costs O(rows) per triangle.
+  std::optional<trace::scope> stage{std::in_place, "prefix sums"};
+  const row_prefix_sums image{t.image_data.get(), t.image_w, t.image_h,
+                              t.image_channels, threads};
+
+  // Every pixel is assigned to the triangle that covers its center.
+  stage.emplace("pixel accumulation");
+  const auto sums = triangle_color_sums(
+      image, t.elements,
+      [&](uint32_t pid) {
+        return point{t.points[pid].x * t.image_h, t.points[pid].y * t.image_h};
+      },
+      threads);
+
+  stage.emplace("vertex colors");
+  t.vertices.resize(t.elements.size());
+  for (size_t i = 0; i < sums.size(); ++i) {
+    if (sums[i].count) {
+      set_color(t, i, sums[i], {});
+      continue;
+    }
+    const auto [y, x] = centroid_pixel(t, i);
+    const auto pixel = t.image_data.get() +
+                       (size_t(y) * t.image_w + x) * t.image_channels;
+    set_color(t, i, {}, pixel_color(pixel, t.image_channels));
+  }
+}
+
+// Colors the triangulation while the binary PPM image is read in strips
+// from top to bottom. Triangles become active when the strip reaches their
+// top and are finalized once it has passed their bottom. Hence, besides the
+// mesh, only one strip and the sums of the active triangles are in memory.
+// The pixel under the centroid is kept as fallback while its strip is read.
+inline void color_strips(tessellation& t, int strip_rows, size_t threads) {
+  const trace::scope stage{"strip coloring"};
+  ppm_reader reader{t.path};
+  if ((reader.width != t.image_w) || (reader.height != t.image_h))
+    throw std::runtime_error("The image '" + t.path + "' has changed!");
+
+  const float h = t.image_h;
+  const size_t n = t.elements.size() / 3;
+  const auto pixel = [&](size_t i, size_t j) {
+    const auto& p = t.points[t.elements[3 * i + j]];
+    return point{p.x * h, p.y * h};
+  };
+  std::vector<float> bottom(n), top(n);
+  for (size_t i = 0; i < n; ++i) {
+    const auto [lo, hi] =
+        std::minmax({pixel(i, 0).y, pixel(i, 1).y, pixel(i, 2).y});
+    bottom[i] = lo;
+    top[i] = hi;
+  }
+  std::vector<uint32_t> order(n);
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(),
+            [&](uint32_t x, uint32_t y) { return top[x] > top[y]; });
+
+  struct active_triangle {
+    uint32_t id;
+    int centroid_row;
+    int centroid_column;
+    color_sum sum;
+    color_sum fallback;
+  };
+  std::vector<active_triangle> active{};
+  size_t next = 0;
+  t.vertices.resize(t.elements.size());
+  const size_t row = size_t(t.image_w) * reader.channels;
+  std::vector<uint8_t> strip(size_t(strip_rows) * row);
+  for (int y1 = t.image_h; y1 > 0; y1 -= strip_rows) {
+    // Rows are stored from bottom to top like the flipped images of stb.
+    const int y0 = std::max(0, y1 - strip_rows);
+    const int rows = y1 - y0;
+    reader.read_rows(strip.data(), rows);
+    for (int r = 0; r < rows / 2; ++r)
+      std::swap_ranges(&strip[r * row], &strip[(r + 1) * row],
+                       &strip[(rows - 1 - r) * row]);
+    const row_prefix_sums sums{strip.data(), t.image_w, rows, reader.channels,
+                               threads};
+
+    // The last strip takes all remaining triangles, such that triangles
+    // below the image still get the color of their clamped centroid.
+    for (; (next < n) && ((top[order[next]] > y0) || (y0 == 0)); ++next) {
+      const auto [y, x] = centroid_pixel(t, order[next]);
+      active.push_back({order[next], y, x, {}, {}});
+    }
+    parallel_for(active.size(), threads, [&](size_t k, size_t) {
+      auto& a = active[k];
+      accumulate_color_sum(a.sum, sums, y0, pixel(a.id, 0), pixel(a.id, 1),
+                           pixel(a.id, 2));
+      if (!a.fallback.count && (a.centroid_row >= y0)) {
+        const int r = std::min(a.centroid_row, y1 - 1) - y0;
+        a.fallback = pixel_color(
+            &strip[r * row + size_t(a.centroid_column) * reader.channels],
+            reader.channels);
+      }
+    });
+    std::erase_if(active, [&](const active_triangle& a) {
+      if ((y0 > 0) && (bottom[a.id] < y0)) return false;
+      set_color(t, a.id, a.sum, a.fallback);
+      return true;
+    });
+  }
+}
+
+inline void color_triangles(tessellation& t, const tessellation_options& opts,
+                            size_t threads) {
+  if (opts.strip_rows)
+    color_strips(t, opts.strip_rows, threads);
+  else
+    color_triangles(t, threads);
+}
+
+inline void export_svg(const tessellation& t, const std::string& path,
+                       const tessellation_options& opts, size_t threads) {
+  const trace::scope stage{"svg"};
+  const auto& vertices = t.vertices;
+  const float h = t.image_h;
+  const auto color = [&](size_t i) { return quantized_color(vertices[3 * i]); };
+
+  if (opts.merge_tolerance >= 0) {
+    std::vector<point> points(t.points.size());
+    for (size_t i = 0; i < points.size(); ++i)
+      points[i] = {t.points[i].x * h, (1.0f - t.points[i].y) * h};
+    std::vector<svg_color> colors(vertices.size() / 3);
+    for (size_t i = 0; i < colors.size(); ++i) colors[i] = color(i);
+    write_svg_paths(path, t.image_w, t.image_h, points, t.elements, colors,
+                    opts.merge_tolerance, opts.svg_precision);
+    return;
+  }
+
+  write_svg(
+      path, t.image_w, t.image_h, vertices.size() / 3,
+      [&](size_t i) {
+        const auto v = &vertices[3 * i];
+        return svg_triangle{{{v[0].x * h, (1.0f - v[0].y) * h},
+                             {v[1].x * h, (1.0f - v[1].y) * h},
+                             {v[2].x * h, (1.0f - v[2].y) * h}},
+                            color(i)};
+      },
+      opts.svg_precision, threads);
+}
+
+// Rasterizes the colored triangles on the CPU with a white background.
+inline void render(const tessellation& t, const std::string& path,
+                   const std::string& format, size_t threads) {
+  const trace::scope stage{"render"};
+  struct pixel_triangle {
+    point p[3];
+    svg_color color;
+  };
+  const float h = t.image_h;
+  std::vector<uint8_t> rgb(size_t(t.image_w) * t.image_h * 3, 255);
+  render_triangles(
+      rgb, t.image_w, t.image_h, t.vertices.size() / 3,
+      [&](size_t i) {
+        const auto v = &t.vertices[3 * i];
+        return pixel_triangle{{{v[0].x * h, v[0].y * h},
+                               {v[1].x * h, v[1].y * h},
+                               {v[2].x * h, v[2].y * h}},
+                              quantized_color(v[0])};
+      },
+      threads);
+  if (format == "ppm")
+    write_ppm(path, t.image_w, t.image_h, rgb);
+  else
+    write_bmp(path, t.image_w, t.image_h, rgb);
+}
+
+// Writes <name>.svg and, in headless mode, the rendered <name>.<format>.
+inline void write_outputs(const tessellation& t, const std::string& name,
+                          const tessellation_options& opts, size_t threads) {
+  export_svg(t, name + ".svg", opts, threads);
+  if (!opts.headless.empty())
+    render(t, name + "." + opts.headless, opts.headless, threads);
+}
+
+}  // namespace delaunay
@@ -0,0 +1,154 @@
+#include <algorithm>
+#include <cctype>
+#include <delaunay/pipeline.hpp>
+#include <delaunay/tessellation.hpp>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Usage: tessellation_batch [options] <directory | manifest>
+//   --output <directory>   directory of the results, default "."
+//   --queue <n>            capacity of the queues between the stages
+//   --threads <stage>=<n>  threads of the stage decode, sample, triangulate,
+//                          color or write
+// All images of the directory or the paths listed line by line in the
+// manifest are tessellated by a pipeline of stages with their own threads.
+// Every image is written to <output>/<stem>.svg. Images whose stems collide
+// keep their extension, as in <output>/<file>.svg, and a counter is appended
+// if the names are still not unique. The tessellation options are listed
+// in delaunay::tessellation_usage. No window is opened.
+int main(int argc, char** argv) {
+  using namespace std;
+  namespace fs = std::filesystem;
+  using delaunay::tessellation;
+
+  // Image with the name of its outputs.
+  struct job {
+    string name;
+    tessellation t;
+  };
+
+  delaunay::tessellation_options opts{};
+  fs::path output{"."};
+  size_t capacity = 4;
+  map<string, size_t> threads{{"decode", 2},
+                              {"sample", 1},
+                              {"triangulate", delaunay::default_thread_count()},
+                              {"color", 2},
+                              {"write", 2}};
+  string input{};
+  for (int i = 1; i < argc; ++i) {
+    const string arg{argv[i]};
+    if (opts.parse(i, argc, argv)) continue;
+    if ((arg == "--output") && (i + 1 < argc)) {
+      output = argv[++i];
+    } else if ((arg == "--queue") && (i + 1 < argc)) {
+      capacity = max(size_t{1}, size_t(stoul(argv[++i])));
+    } else if ((arg == "--threads") && (i + 1 < argc)) {
+      const string value{argv[++i]};
+      const auto split = value.find('=');
+      if ((split == string::npos) || !threads.contains(value.substr(0, split)))
+        throw invalid_argument{"Unknown stage in '" + value + "'!"};
+      threads[value.substr(0, split)] = stoul(value.substr(split + 1));
+    } else if (!arg.starts_with("--") && input.empty()) {
+      input = arg;
+    } else {
+      throw invalid_argument{"Unknown argument '" + arg + "'!\n" +
+                             delaunay::tessellation_usage};
+    }
+  }
+  if (input.empty())
+    throw invalid_argument{
+        "Usage: tessellation_batch [options] <directory | manifest>\n"s +
+        delaunay::tessellation_usage};
+  opts.check();
+
+  const auto lower = [](string s) {
+    for (auto& c : s) c = tolower(c);
+    return s;
+  };
+
+  // Only files with the extensions of stb_image are taken from directories.
+  vector<fs::path> paths{};
+  if (fs::is_directory(input)) {
+    const vector<string> extensions{".bmp", ".gif", ".hdr", ".jpeg",
+                                    ".jpg", ".pgm", ".pic", ".png",
+                                    ".pnm", ".ppm", ".psd", ".tga"};
+    for (const auto& entry : fs::directory_iterator{input})
+      if (entry.is_regular_file() &&
+          ranges::binary_search(extensions,
+                                lower(entry.path().extension().string())))
+        paths.push_back(entry.path());
+    ranges::sort(paths);
+  } else {
+    ifstream manifest{input};
+    if (!manifest) throw runtime_error{"Could not open '" + input + "'!"};
+    for (string line; getline(manifest, line);)
+      if (!line.empty() && !line.starts_with('#')) paths.push_back(line);
+  }
+
+  // Names are compared without case for case-insensitive file systems.
+  map<string, size_t> stems{};
+  for (const auto& path : paths) ++stems[lower(path.stem().string())];
+  vector<job> jobs{};
+  set<string> names{};
+  for (const auto& path : paths) {
+    const auto base = (stems[lower(path.stem().string())] > 1)
+                          ? path.filename().string()
+                          : path.stem().string();
+    auto name = base;
+    for (size_t k = 2; names.contains(lower(name)); ++k)
+      name = base + "-" + to_string(k);
+    names.insert(lower(name));
+    jobs.push_back({name, {path.string()}});
+  }
+  fs::create_directories(output);
+  stbi_set_flip_vertically_on_load(true);
+
+  // Stages that are parallel by themselves run single-threaded per image,
+  // such that the pools of the stages decide how the cores are shared.
+  const vector<delaunay::pipeline_stage<job>> stages{
+      {"decode", threads["decode"],
+       [&](job& j) { j.t = delaunay::decode_image(j.t.path, opts); }},
+      {"sample", threads["sample"],
+       [&](job& j) { delaunay::sample_points(j.t, opts, 1); }},
+      {"triangulate", threads["triangulate"],
+       [](job& j) { delaunay::triangulate_points(j.t); }},
+      {"color", threads["color"],
+       [&](job& j) {
+         delaunay::color_triangles(j.t, opts, 1);
+         // The image is not needed anymore.
+         j.t.image_data.reset();
+       }},
+      {"write", threads["write"],
+       [&](job& j) {
+         delaunay::write_outputs(j.t, (output / j.name).string(), opts, 1);
+       }},
+  };
+
+  const size_t images = jobs.size();
+  const auto stats = delaunay::run_pipeline(std::move(jobs), stages, capacity);
+
+  cout << "images = " << images << "\nqueue capacity = " << capacity << "\n\n"
+       << left << setw(14) << "stage" << right << setw(8) << "threads"
+       << setw(8) << "items" << setw(10) << "failures" << setw(12) << "time [s]"
+       << setw(12) << "items/s" << setw(13) << "utilization" << setw(11)
+       << "max queue" << '\n';
+  size_t failures = 0;
+  for (const auto& s : stats) {
+    cout << left << setw(14) << s.name << right << setw(8) << s.threads
+         << setw(8) << s.items << setw(10) << s.failures << fixed
+         << setprecision(3) << setw(12) << s.seconds << setprecision(1)
+         << setw(12) << s.items_per_second() << setprecision(2) << setw(13)
+         << s.utilization() << setw(11) << s.max_queue << '\n';
+    failures += s.failures;
+    for (const auto& e : s.errors) cerr << s.name << ": " << e << '\n';
+  }
+  return failures ? 1 : 0;
+}
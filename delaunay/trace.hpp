@@ -0,0 +1,118 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Scoped trace events that are written as Chrome trace JSON.
+// The file can be loaded in chrome://tracing or ui.perfetto.dev.
+// Tracing is enabled by setting the environment variable DELAUNAY_TRACE
+// to the output path or by calling trace::start. While it is disabled,
+// a scope only costs a relaxed atomic load.
+namespace delaunay::trace {
+
+using clock = std::chrono::steady_clock;
+
+struct event {
+  const char* name;
+  clock::time_point start;
+  clock::time_point end;
+};
+
+// Every thread appends to its own buffer. Buffers are shared with the
+// tracer, so events of finished threads are still written at the end.
+struct thread_buffer {
+  uint32_t tid{};
+  std::mutex mutex{};
+  std::vector<event> events{};
+};
+
+struct tracer {
+  tracer() {
+    if (const auto path = std::getenv("DELAUNAY_TRACE")) start(path);
+  }
+  ~tracer() { stop(); }
+
+  void start(std::string file) {
+    const std::scoped_lock lock{mutex};
+    path = std::move(file);
+    origin = clock::now();
+    enabled.store(true, std::memory_order_relaxed);
+  }
+
+  // Writes all recorded events to the file given to start.
+  // Traced scopes should not run concurrently to this call.
+  void stop() {
+    if (!enabled.exchange(false, std::memory_order_relaxed)) return;
+    const std::scoped_lock lock{mutex};
+    std::ofstream file{path};
+    file << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+    bool first = true;
+    for (auto& buffer : buffers) {
+      const std::scoped_lock buffer_lock{buffer->mutex};
+      for (const auto& e : buffer->events) {
+        using us = std::chrono::duration<double, std::micro>;
+        file << (first ? "\n" : ",\n") << "{\"name\": \"" << e.name
+             << "\", \"ph\": \"X\", \"pid\": 1, \"tid\": " << buffer->tid
+             << ", \"ts\": " << us(e.start - origin).count()
+             << ", \"dur\": " << us(e.end - e.start).count() << "}";
+        first = false;
+      }
+      buffer->events.clear();
+    }
+    file << "\n]}\n";
+  }
+
+  std::shared_ptr<thread_buffer> register_thread() {
+    const std::scoped_lock lock{mutex};
+    auto buffer = std::make_shared<thread_buffer>();
+    buffer->tid = buffers.size();
+    buffers.push_back(buffer);
+    return buffer;
+  }
+
+  std::atomic<bool> enabled{false};
+  std::mutex mutex{};
+  std::string path{};
+  clock::time_point origin{};
+  std::vector<std::shared_ptr<thread_buffer>> buffers{};
+};
+
+inline tracer global{};
+
+inline bool enabled() noexcept {
+  return global.enabled.load(std::memory_order_relaxed);
+}
+
+inline void start(std::string path) { global.start(std::move(path)); }
+inline void stop() { global.stop(); }
+
+inline void record(const char* name, clock::time_point start,
+                   clock::time_point end) {
+  thread_local const auto buffer = global.register_thread();
+  const std::scoped_lock lock{buffer->mutex};
+  buffer->events.push_back({name, start, end});
+}
+
+// Records the lifetime of the scope as one event.
+// The name has to be a string literal.
+struct scope {
+  explicit scope(const char* n) noexcept
+      : name{enabled() ? n : nullptr},
+        start{name ? clock::now() : clock::time_point{}} {}
+  scope(const scope&) = delete;
+  scope& operator=(const scope&) = delete;
+  ~scope() {
+    if (name) record(name, start, clock::now());
+  }
+
+  const char* name;
+  clock::time_point start;
+};
+
+}  // namespace delaunay::trace
@@ -0,0 +1,194 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <delaunay/geometry.hpp>
+#include <delaunay/parallel.hpp>
+#include <delaunay/points.hpp>
+#include <numeric>
+#include <ostream>
+#include <span>
+#include <vector>
+
+namespace delaunay {
+
+// Result of verify. Every counter apart from the sizes counts violations.
+struct verification {
+  bool valid() const noexcept {
+    return !invalid_triangles && !inverted_triangles && !nonmanifold_edges &&
+           !hull_errors && !non_delaunay_edges &&
+           (!triangles || (euler_characteristic() == 1));
+  }
+
+  // V - E + F of the mesh, which is one for a triangulated convex polygon.
+  ptrdiff_t euler_characteristic() const noexcept {
+    return ptrdiff_t(vertices) - ptrdiff_t(edges) + ptrdiff_t(triangles);
+  }
+
+  verification& operator+=(const verification& v) noexcept {
+    vertices += v.vertices;
+    edges += v.edges;
+    triangles += v.triangles;
+    boundary_edges += v.boundary_edges;
+    invalid_triangles += v.invalid_triangles;
+    inverted_triangles += v.inverted_triangles;
+    nonmanifold_edges += v.nonmanifold_edges;
+    hull_errors += v.hull_errors;
+    non_delaunay_edges += v.non_delaunay_edges;
+    return *this;
+  }
+
+  // Referenced vertices, undirected edges and triangles.
+  size_t vertices{};
+  size_t edges{};
+  size_t triangles{};
+  size_t boundary_edges{};
+  // Indices out of range or repeated inside a triangle.
+  size_t invalid_triangles{};
+  // Clockwise or degenerate triangles.
+  size_t inverted_triangles{};
+  // Directed edges that are used by more than one triangle.
+  size_t nonmanifold_edges{};
+  // Boundary vertices without a unique successor or with a reflex angle.
+  size_t hull_errors{};
+  // Interior edges whose opposite vertex lies inside the circumcircle.
+  size_t non_delaunay_edges{};
+};
+
+inline std::ostream& operator<<(std::ostream& os, const verification& v) {
+  return os << (v.valid() ? "valid" : "invalid") << ": V = " << v.vertices
+            << ", E = " << v.edges << ", F = " << v.triangles
+            << ", V - E + F = " << v.euler_characteristic()
+            << ", boundary edges = " << v.boundary_edges
+            << ", invalid triangles = " << v.invalid_triangles
+            << ", inverted triangles = " << v.inverted_triangles
+            << ", non-manifold edges = " << v.nonmanifold_edges
+            << ", hull errors = " << v.hull_errors
+            << ", non-Delaunay edges = " << v.non_delaunay_edges;
+}
+
+// Checks that the counterclockwise triangles given by the index array form
+// a Delaunay triangulation of the convex hull of the referenced points.
+// Half-edges are sharded by their origin vertex in a parallel counting
+// sort. Afterwards, every edge finds its twin in the shard of its target,
+// so all checks take linear time apart from sorting every shard.
+// Local Delaunayhood of all interior edges implies the global property.
+template <point_source Points>
+verification verify(const Points& points, std::span<const uint32_t> indices,
+                     size_t threads = default_thread_count()) {
+  struct half_edge {
+    uint32_t to, opposite;
+  };
+  const auto at = [&points](uint32_t i) {
+    return geometry::point{points[i].x, points[i].y};
+  };
+
+  const size_t n = points.size();
+  const size_t m = indices.size() / 3;
+  threads = std::max(size_t{1}, threads);
+  std::vector<verification> partial(threads);
+  const auto chunk_loop = [threads](size_t size, auto&& f) {
+    const auto chunks = std::min(size, 8 * threads);
+    parallel_for(chunks, threads, [&](size_t chunk, size_t thread) {
+      for (auto i = chunk * size / chunks; i < (chunk + 1) * size / chunks;
+           ++i)
+        f(i, thread);
+    });
+  };
+
+  // Check every triangle on its own and count the half-edges per origin.
+  std::vector<uint8_t> valid(m);
+  std::vector<std::atomic<uint32_t>> counts(n);
+  chunk_loop(m, [&](size_t t, size_t thread) {
+    const auto v = &indices[3 * t];
+    auto& r = partial[thread];
+    if ((v[0] >= n) || (v[1] >= n) || (v[2] >= n) || (v[0] == v[1]) ||
+        (v[1] == v[2]) || (v[2] == v[0])) {
+      ++r.invalid_triangles;
+      return;
+    }
+    valid[t] = true;
+    if (geometry::orientation(at(v[0]), at(v[1]), at(v[2])) <= 0.0)
+      ++r.inverted_triangles;
+    for (size_t k = 0; k < 3; ++k)
+      counts[v[k]].fetch_add(1, std::memory_order_relaxed);
+  });
+
+  std::vector<size_t> offsets(n + 1);
+  for (size_t i = 0; i < n; ++i)
+    offsets[i + 1] = counts[i].exchange(0, std::memory_order_relaxed);
+  std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+  std::vector<half_edge> edges(offsets[n]);
+  chunk_loop(m, [&](size_t t, size_t) {
+    if (!valid[t]) return;
+    const auto v = &indices[3 * t];
+    for (size_t k = 0; k < 3; ++k) {
+      const auto a = v[k];
+      const auto slot = counts[a].fetch_add(1, std::memory_order_relaxed);
+      edges[offsets[a] + slot] = {v[(k + 1) % 3], v[(k + 2) % 3]};
+    }
+  });
+
+  const auto shard = [&](uint32_t a) {
+    return std::span{edges}.subspan(offsets[a], offsets[a + 1] - offsets[a]);
+  };
+  const auto by_target = [](const half_edge& e, const half_edge& f) {
+    return e.to < f.to;
+  };
+  chunk_loop(n, [&](size_t a, size_t) {
+    const auto s = shard(a);
+    std::sort(s.begin(), s.end(), by_target);
+  });
+  const auto find = [&](uint32_t a, uint32_t b) -> const half_edge* {
+    const auto s = shard(a);
+    const auto it =
+        std::lower_bound(s.begin(), s.end(), half_edge{b, 0}, by_target);
+    return ((it != s.end()) && (it->to == b)) ? &*it : nullptr;
+  };
+
+  chunk_loop(n, [&](size_t i, size_t thread) {
+    const auto a = uint32_t(i);
+    const auto s = shard(a);
+    auto& r = partial[thread];
+    r.vertices += !s.empty();
+    for (size_t k = 0; k < s.size(); ++k) {
+      const auto& e = s[k];
+      if ((k > 0) && (s[k - 1].to == e.to)) {
+        ++r.nonmanifold_edges;
+        continue;
+      }
+      const auto twin = find(e.to, a);
+      if (twin) {
+        if (a > e.to) continue;
+        ++r.edges;
+        if (geometry::circumcircle_intersection(
+                {{at(a), at(e.to), at(e.opposite)}}, at(twin->opposite)))
+          ++r.non_delaunay_edges;
+        continue;
+      }
+
+      // The boundary is traversed counterclockwise. The boundary edge
+      // starting at the target has to be unique and turn to the left.
+      ++r.edges;
+      ++r.boundary_edges;
+      size_t successors = 0;
+      uint32_t next = 0;
+      for (const auto& f : shard(e.to)) {
+        if (find(f.to, e.to)) continue;
+        ++successors;
+        next = f.to;
+      }
+      if ((successors != 1) ||
+          (geometry::orientation(at(a), at(e.to), at(next)) < 0.0))
+        ++r.hull_errors;
+    }
+  });
+
+  verification result{};
+  for (const auto& r : partial) result += r;
+  result.triangles = m;
+  return result;
+}
+
+}  // namespace delaunay
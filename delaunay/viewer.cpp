@@ -9,6 +9,7 @@ using namespace gl;
 #include <iomanip>
 #include <iostream>
 #include <random>
+#include <ranges>
 #include <stdexcept>
 #include <string>
 #include <vector>
@@ -75,15 +76,15 @@ int main(void) {
   glm::vec3 pu{1.0f / sqrt(2.0f), -1.0f / sqrt(2.0f), 0.0f};
   glm::vec3 pv{-1.0f / sqrt(6.0f), -1.0f / sqrt(6.0f), 2.0f / sqrt(6.0f)};
   vector<glm::vec3> projected_points = pareto_points;
-  vector<delaunay::point> delaunay_points{};
-  for (auto& p : projected_points) {
-    p = dot(pu, p) * pu + dot(pv, p) * pv;
-    delaunay_points.push_back({dot(pu, p), dot(pv, p)});
-  }
+  for (auto& p : projected_points) p = dot(pu, p) * pu + dot(pv, p) * pv;
 
-  // Triangulate Pareto front.
-  delaunay::triangulation triangulation{};
-  auto elements = triangulation.triangle_data(delaunay_points);
+  // Triangulate Pareto front by borrowing the plane coordinates.
+  delaunay::basic_triangulation triangulation{
+      views::transform(projected_points, [pu, pv](const glm::vec3& p) {
+        return delaunay::point{dot(pu, p), dot(pv, p)};
+      })};
+  triangulation.build();
+  auto elements = triangulation.triangle_data();
 
   float mean_distance = 0;
   for (uint32_t i = 0; i < elements.size(); i += 3) {